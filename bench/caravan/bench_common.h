@@ -0,0 +1,45 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_BENCH_COMMON_H
+#define CARAVAN_BENCH_COMMON_H
+
+#include "caravan/model/game.h"
+#include "caravan/user/bot/normal.h"
+
+const uint64_t BENCH_SEED = 20240601;
+const uint8_t BENCH_MID_GAME_MOVES = 16;
+
+/**
+ * @param seed Seed for the game's decks.
+ * @param num_moves Number of moves for two normal bots to play, stopping
+ *        early if the game is won.
+ * @return The state of a realistic game after those moves.
+ */
+inline GameState bench_mid_game(uint64_t seed, uint8_t num_moves) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC,
+        seed
+    };
+    Game game{&gc};
+    UserBotNormal bot_abc{PLAYER_ABC};
+    UserBotNormal bot_def{PLAYER_DEF};
+    GameState gs;
+
+    for (uint8_t i = 0; i < num_moves and game.get_winner() == NO_PLAYER; ++i) {
+        UserBotNormal *bot = game.get_player_turn() == PLAYER_ABC ? &bot_abc : &bot_def;
+        GameCommand command = bot->request_command(&game);
+
+        game.play_option(&command);
+    }
+
+    gs = game.clone();
+    game.close();
+
+    return gs;
+}
+
+#endif //CARAVAN_BENCH_COMMON_H
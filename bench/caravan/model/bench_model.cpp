@@ -0,0 +1,151 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "benchmark/benchmark.h"
+#include "caravan/model/deck.h"
+#include "caravan/model/game.h"
+#include "bench_common.h"
+
+/*
+ * CARAVAN
+ */
+
+static void BM_Caravan_GetBid(benchmark::State &state) {
+    CaravanState cs{};
+    Caravan cvn{CARAVAN_A, &cs};
+
+    cvn.put_numeral_card({CLUBS, TWO});
+    cvn.put_numeral_card({HEARTS, FIVE});
+    cvn.put_face_card({SPADES, KING}, 2);
+    cvn.put_numeral_card({DIAMONDS, NINE});
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(cvn.get_bid());
+    }
+}
+BENCHMARK(BM_Caravan_GetBid);
+
+static void BM_Caravan_PutNumeralCard(benchmark::State &state) {
+    CaravanState cs_start{};
+    CaravanState cs{};
+    Caravan cvn{CARAVAN_A, &cs};
+
+    cvn.put_numeral_card({CLUBS, TWO});
+    cvn.put_numeral_card({HEARTS, FIVE});
+    cs_start = cs;
+
+    for (auto _: state) {
+        cs = cs_start;
+        cvn.put_numeral_card({DIAMONDS, NINE});
+        benchmark::DoNotOptimize(cs);
+    }
+}
+BENCHMARK(BM_Caravan_PutNumeralCard);
+
+static void BM_Caravan_PutFaceCard(benchmark::State &state) {
+    CaravanState cs_start{};
+    CaravanState cs{};
+    Caravan cvn{CARAVAN_A, &cs};
+
+    cvn.put_numeral_card({CLUBS, TWO});
+    cvn.put_numeral_card({HEARTS, FIVE});
+    cvn.put_numeral_card({DIAMONDS, NINE});
+    cs_start = cs;
+
+    for (auto _: state) {
+        cs = cs_start;
+        cvn.put_face_card({SPADES, KING}, 2);
+        cvn.put_face_card({CLUBS, QUEEN}, 3);
+        benchmark::DoNotOptimize(cs);
+    }
+}
+BENCHMARK(BM_Caravan_PutFaceCard);
+
+/*
+ * TABLE
+ */
+
+static void BM_Table_PlayFaceCard_Joker(benchmark::State &state) {
+    TableState ts_start{};
+    TableState ts{};
+    Table table{&ts};
+
+    // A SEVEN on every caravan, so the JOKER sweeps the whole table
+    for (int i = CARAVAN_A; i <= CARAVAN_F; ++i) {
+        CaravanName cvname = static_cast<CaravanName>(i);
+
+        table.play_numeral_card(cvname, {CLUBS, TWO});
+        table.play_numeral_card(cvname, {static_cast<Suit>(1 + i % 4), SEVEN});
+        table.play_numeral_card(cvname, {HEARTS, TEN});
+    }
+
+    ts_start = ts;
+
+    for (auto _: state) {
+        ts = ts_start;
+        table.play_face_card(CARAVAN_A, {NO_SUIT, JOKER}, 2);
+        benchmark::DoNotOptimize(ts);
+    }
+
+    table.close();
+}
+BENCHMARK(BM_Table_PlayFaceCard_Joker);
+
+/*
+ * GAME
+ */
+
+static void BM_Game_PlayOption(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+    GameCommandList moves;
+    uint8_t i = 0;
+
+    game.legal_moves(game.get_player_turn(), &moves);
+
+    for (auto _: state) {
+        GameCommand command = moves.commands[i];
+
+        game.restore(&gs_start);
+        game.play_option(&command);
+
+        i = (i + 1) % moves.size;
+    }
+
+    game.close();
+}
+BENCHMARK(BM_Game_PlayOption);
+
+static void BM_Game_GetWinner(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(game.get_winner());
+    }
+
+    game.close();
+}
+BENCHMARK(BM_Game_GetWinner);
+
+/*
+ * DECK
+ */
+
+static void BM_DeckBuilder_BuildCaravanDeck(benchmark::State &state) {
+    Random rng(BENCH_SEED);
+    DeckCards deck;
+    uint8_t num_cards = state.range(0);
+    uint8_t num_samples = state.range(1);
+    bool balanced = state.range(2) != 0;
+
+    for (auto _: state) {
+        DeckBuilder::build_caravan_deck(&deck, num_cards, num_samples, balanced, &rng);
+        benchmark::DoNotOptimize(deck);
+    }
+}
+BENCHMARK(BM_DeckBuilder_BuildCaravanDeck)
+    ->Args({54, 1, 1})
+    ->Args({90, 2, 0})
+    ->Args({162, 3, 1});
@@ -0,0 +1,75 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "benchmark/benchmark.h"
+#include "caravan/user/bot/normal.h"
+#include "caravan/user/bot/neural.h"
+#include "bench_common.h"
+
+static void BM_UserBotNormal_RequestMove(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+    UserBotNormal bot{game.get_player_turn()};
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(bot.request_move(&game));
+    }
+
+    bot.close();
+    game.close();
+}
+BENCHMARK(BM_UserBotNormal_RequestMove);
+
+static void BM_UserBotNormal_RequestCommand(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+    UserBotNormal bot{game.get_player_turn()};
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(bot.request_command(&game));
+    }
+
+    bot.close();
+    game.close();
+}
+BENCHMARK(BM_UserBotNormal_RequestCommand);
+
+static void BM_EncodeFeatures(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+    Features features;
+
+    for (auto _: state) {
+        encode_features(&game, game.get_player_turn(), &features);
+        benchmark::DoNotOptimize(features);
+    }
+
+    game.close();
+}
+BENCHMARK(BM_EncodeFeatures);
+
+static void BM_NeuralNet_Evaluate(benchmark::State &state) {
+    GameState gs_start = bench_mid_game(BENCH_SEED, BENCH_MID_GAME_MOVES);
+    Game game{&gs_start};
+    NeuralNet net{{32, 32}, BENCH_SEED};
+    Features features;
+
+    if (!NeuralNet::supports((NeuralKernel) state.range(0))) {
+        state.SkipWithError("Kernel not supported.");
+        net.close();
+        game.close();
+        return;
+    }
+
+    net.set_kernel((NeuralKernel) state.range(0));
+    encode_features(&game, game.get_player_turn(), &features);
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(net.evaluate(&features));
+    }
+
+    net.close();
+    game.close();
+}
+BENCHMARK(BM_NeuralNet_Evaluate)->Arg(NEURAL_SCALAR)->Arg(NEURAL_SSE)->Arg(NEURAL_AVX2);
@@ -9,6 +9,7 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <type_traits>
 
 /*
  * CONSTANTS
@@ -30,22 +31,25 @@ const uint8_t HAND_SIZE_MAX_POST_START = 5;
 const uint8_t HAND_POS_MIN = 1;
 const uint8_t TABLE_CARAVANS_MAX = 6;
 const uint8_t PLAYER_CARAVANS_MAX = 3;
+const uint8_t MOVES_LEGAL_MAX =  // face cards on every slot, discards, clears
+    HAND_SIZE_MAX_POST_START * TABLE_CARAVANS_MAX * TRACK_NUMERIC_MAX +
+    HAND_SIZE_MAX_POST_START + PLAYER_CARAVANS_MAX;
 
 /*
  * ENUMS
  */
 
-enum PlayerName {
+enum PlayerName : uint8_t {
     NO_PLAYER,
     PLAYER_ABC,
     PLAYER_DEF
 };
-enum Direction {
+enum Direction : uint8_t {
     ANY,
     ASCENDING,
     DESCENDING
 };
-enum CaravanName {
+enum CaravanName : uint8_t {
     NO_CARAVAN,
     CARAVAN_A,
     CARAVAN_B,
@@ -54,20 +58,20 @@ enum CaravanName {
     CARAVAN_E,
     CARAVAN_F
 };
-enum OptionType {
+enum OptionType : uint8_t {
     NO_OPTION,
     OPTION_PLAY,
     OPTION_DISCARD,
     OPTION_CLEAR
 };
-enum Suit {
+enum Suit : uint8_t {
     NO_SUIT,
     CLUBS,
     DIAMONDS,
     HEARTS,
     SPADES
 };
-enum Rank {
+enum Rank : uint8_t {
     ACE,
     TWO,
     THREE,
@@ -88,11 +92,14 @@ enum Rank {
  * TYPES
  */
 
+// Packed into a single byte, so that hands, tracks and decks copy cheaply
 typedef struct Card {
-    Suit suit{};
-    Rank rank{};
+    Suit suit : 3 {};
+    Rank rank : 5 {};
 } Card;
 
+static_assert(sizeof(Card) == 1);
+
 typedef std::array<Card, HAND_SIZE_MAX_START> Hand;
 typedef std::vector<Card> Deck;
 typedef std::array<Card, TRACK_FACE_MAX> Faces;
@@ -105,6 +112,41 @@ typedef struct Slot {
 } Slot;
 
 typedef std::array<Slot, TRACK_NUMERIC_MAX> Track;
+typedef std::array<Card, DECK_CARAVAN_MAX> DeckCards;
+
+typedef struct CaravanState {
+    Track track{};
+    uint8_t i_track{0};
+
+    // Kept up to date on every change to the track
+    uint8_t suits_present{0};  // a bit per suit of its numeral cards
+    uint16_t bid{0};
+    Direction direction{ANY};
+    Suit suit{NO_SUIT};
+    uint16_t ranks_present{0};  // a bit per rank of its numeral cards
+    uint64_t hash{0};  // Zobrist hash of the track
+} CaravanState;
+
+typedef std::array<CaravanState, TABLE_CARAVANS_MAX> TableState;
+
+typedef struct PlayerState {
+    Hand hand{};
+    uint8_t i_hand{0};
+    DeckCards deck{};  // top of deck is at i_deck - 1
+    uint8_t i_deck{0};
+    uint16_t moves{0};
+    uint64_t hash{0};  // Zobrist hash of the hand and remaining deck
+} PlayerState;
+
+typedef struct GameState {
+    TableState table{};
+    PlayerState pa{};
+    PlayerState pb{};
+    PlayerName p_turn{NO_PLAYER};
+} GameState;
+
+// A game state holds no pointers, so it can be cloned with a single memcpy
+static_assert(std::is_trivially_copyable_v<GameState>);
 
 typedef struct GameConfig {
     uint8_t player_abc_cards{0};
@@ -116,6 +158,8 @@ typedef struct GameConfig {
     bool player_def_balanced{false};
 
     PlayerName player_first{NO_PLAYER};
+
+    uint64_t seed{0};  // decks are built from this seed, or at random if 0
 } GameConfig;
 
 typedef struct GameCommand {
@@ -127,16 +171,94 @@ typedef struct GameCommand {
     Card board{};
 } GameCommand;
 
+typedef struct RemovedSlot {
+    CaravanName caravan_name{NO_CARAVAN};
+    uint8_t pos{0};  // position before the slot was removed
+    Slot slot{};
+} RemovedSlot;
+
+typedef struct GameUndo {
+    GameCommand command{};  // as played, including the cards it logged
+    PlayerName p_turn{NO_PLAYER};
+    bool drew{false};
+
+    // Caravan totals before the move
+    std::array<uint8_t, TABLE_CARAVANS_MAX> i_track{};
+    std::array<uint16_t, TABLE_CARAVANS_MAX> bid{};
+    std::array<Direction, TABLE_CARAVANS_MAX> direction{};
+    std::array<Suit, TABLE_CARAVANS_MAX> suit{};
+    std::array<uint8_t, TABLE_CARAVANS_MAX> suits_present{};
+    std::array<uint16_t, TABLE_CARAVANS_MAX> ranks_present{};
+    std::array<uint64_t, TABLE_CARAVANS_MAX> hash{};
+    uint64_t hash_player{0};
+
+    // Storage overwritten by the card that was played or drawn
+    Slot slot_overwritten{};
+    Card face_overwritten{};
+    Card hand_overwritten{};
+
+    // Slots removed by a JACK or by a JOKER, in ascending position order
+    std::array<RemovedSlot, TABLE_CARAVANS_MAX * TRACK_NUMERIC_MAX> removed{};
+    uint8_t i_removed{0};
+} GameUndo;
+
+typedef struct GameCommandList {
+    std::array<GameCommand, MOVES_LEGAL_MAX> commands{};
+    uint8_t size{0};
+} GameCommandList;
+
+/*
+ * TABLES
+ */
+
+// Indexed by every rank that fits in a card; ranks past JOKER are invalid
+const uint8_t CARD_RANKS = 32;
+
+constexpr std::array<uint8_t, CARD_RANKS> RANK_VALUE = {
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10,  // ACE to TEN
+    0, 0, 0, 0                      // JACK, QUEEN, KING, JOKER
+};
+
+constexpr std::array<bool, CARD_RANKS> RANK_NUMERAL = {
+    true, true, true, true, true, true, true, true, true, true,
+    false, false, false, false
+};
+
+constexpr std::array<bool, CARD_RANKS> RANK_FACE = {
+    false, false, false, false, false, false, false, false, false, false,
+    true, true, true, true
+};
+
+// Indexed by caravan name, NO_CARAVAN first
+constexpr std::array<const char *, TABLE_CARAVANS_MAX + 1> CARAVAN_LETTER = {
+    "", "A", "B", "C", "D", "E", "F"
+};
+
 /*
  * FUNCTIONS
  */
 
-bool is_numeral_card(Card c);
+inline bool is_numeral_card(Card c) { return RANK_NUMERAL[c.rank]; }
+
+inline bool is_face_card(Card c) { return RANK_FACE[c.rank]; }
 
-bool is_face_card(Card c);
+// The value of a numeral card, or 0 for a face card; never throws
+inline uint8_t card_value(Card c) { return RANK_VALUE[c.rank]; }
 
 std::string caravan_letter(CaravanName caravan_name);
 
 uint8_t numeral_rank_value(Card c);
 
+void parse_command(std::string input, GameCommand *command);
+
+std::string format_command(GameCommand *command);
+
+uint64_t zobrist_track(CaravanName cvname, uint8_t index, uint8_t layer, Card c);
+
+uint64_t zobrist_hand(PlayerName pname, uint8_t index, Card c);
+
+uint64_t zobrist_deck(PlayerName pname, uint8_t index, Card c);
+
+uint64_t zobrist_turn(PlayerName pname);
+
 #endif //CARAVAN_CORE_COMMON_H
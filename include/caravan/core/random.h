@@ -0,0 +1,60 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_CORE_RANDOM_H
+#define CARAVAN_CORE_RANDOM_H
+
+#include <cstdint>
+#include <array>
+#include <limits>
+
+
+class Random {
+protected:
+    std::array<uint64_t, 4> s;
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    typedef uint64_t result_type;
+
+    /**
+     * A xoshiro256** generator. It is small and fast enough for every thread,
+     * or every game, to own one, and the same seed always produces the same
+     * sequence on every platform.
+     *
+     * @param seed The seed, which is expanded into the full state.
+     */
+    explicit Random(uint64_t seed);
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return next(); }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+
+        return result;
+    }
+
+    uint32_t below(uint32_t bound);
+
+    double unit() { return (next() >> 11) * 0x1.0p-53; }
+
+    static uint64_t seed_from_system();
+
+    static Random *for_this_thread();
+};
+
+#endif //CARAVAN_CORE_RANDOM_H
@@ -5,6 +5,7 @@
 #ifndef CARAVAN_MODEL_CARAVAN_H
 #define CARAVAN_MODEL_CARAVAN_H
 
+#include <cassert>
 #include <cstdint>
 #include <array>
 #include "caravan/model/deck.h"
@@ -15,24 +16,39 @@ class Caravan {
 
 protected:
     CaravanName name;
-    Track track;
-    uint8_t i_track;
+    CaravanState *cs;
     bool closed;
 
-    static uint8_t numeral_rank_to_uint8_t(Rank rank);
+    static uint16_t slot_value(Slot slot);
 
     void remove_numeral_card(uint8_t index);
 
+    void remove_present(uint16_t ranks, uint8_t suits, uint8_t pos_exclude);
+
+    uint64_t hash_slot(uint8_t index);
+
+    void update_present();
+
+    void update_tail();
+
+    bool follows_caravan(Card card);
+
 public:
     /**
      * A caravan that contains all of the information for a given track of numeral
      * cards and any face cards attached to them, including: the total caravan bid,
-     * its direction, and its suit.
+     * its direction, and its suit. The track is held in state owned by the
+     * caller, such as a game state.
      *
      * @param cvname The caravan name.
+     * @param state The state of the caravan's track.
      */
-    explicit Caravan(CaravanName cvname) :
-        name(cvname), track({}), i_track(0), closed(false) {};
+    explicit Caravan(CaravanName cvname, CaravanState *state) :
+        name(cvname), cs(state), closed(false) {};
+
+    Caravan(const Caravan &) = delete;
+
+    Caravan &operator=(const Caravan &) = delete;
 
     void clear();
 
@@ -48,6 +64,10 @@ public:
 
     Suit get_suit();
 
+    bool can_put_numeral_card(Card card);
+
+    bool can_put_face_card(Card card, uint8_t pos);
+
     void put_numeral_card(Card card);
 
     Card put_face_card(Card card, uint8_t pos);
@@ -57,6 +77,25 @@ public:
     void remove_suit(Suit suit, uint8_t pos_exclude);
 
     void close();
+
+    /*
+     * Unchecked accessors for the engine (the move generator, bots and
+     * simulator), which only ask about open caravans and positions they have
+     * already validated. Debug builds assert what the get_ methods check.
+     */
+
+    uint16_t bid() const { assert(!closed); return cs->bid; }
+
+    Direction direction() const { assert(!closed); return cs->direction; }
+
+    uint8_t size() const { assert(!closed); return cs->i_track; }
+
+    const Slot &slot(uint8_t pos) const {
+        assert(!closed and pos >= TRACK_NUMERIC_MIN and pos <= cs->i_track);
+        return cs->track[pos - 1];
+    }
+
+    Suit suit() const { assert(!closed); return cs->suit; }
 };
 
 #endif //CARAVAN_MODEL_CARAVAN_H
@@ -6,12 +6,25 @@
 #define CARAVAN_MODEL_DECK_H
 
 #include "caravan/core/common.h"
+#include "caravan/core/random.h"
+
+typedef struct SampleDeck {
+    std::array<Card, DECK_TRADITIONAL_MAX> cards{};  // numerals, then faces
+    uint8_t num_numerals{0};
+    uint8_t num_faces{0};
+} SampleDeck;
 
 class DeckBuilder {
 protected:
-    static Deck build_traditional_deck(bool shuffle);
+    static void fill_sample_deck(SampleDeck *sd);
+
+    static Card draw_numeral(SampleDeck *sd, Random *rng);
+
+    static Card draw_face(SampleDeck *sd, Random *rng);
 
-    static Deck shuffle_deck(Deck d);
+    static Card draw_any(SampleDeck *sd, Random *rng);
+
+    static double prob_numerals(uint8_t num_drawn, uint8_t num_numerals);
 
 public:
     DeckBuilder() = delete;
@@ -20,6 +33,19 @@ public:
         uint8_t num_cards,
         uint8_t num_sample_decks,
         bool balanced_sample);
+
+    static Deck *build_caravan_deck(
+        uint8_t num_cards,
+        uint8_t num_sample_decks,
+        bool balanced_sample,
+        Random *rng);
+
+    static void build_caravan_deck(
+        DeckCards *deck,
+        uint8_t num_cards,
+        uint8_t num_sample_decks,
+        bool balanced_sample,
+        Random *rng);
 };
 
 #endif //CARAVAN_MODEL_DECK_H
@@ -5,21 +5,34 @@
 #ifndef CARAVAN_MODEL_GAME_H
 #define CARAVAN_MODEL_GAME_H
 
+#include <cassert>
 #include <cstdint>
 #include "caravan/model/table.h"
 #include "caravan/model/player.h"
 #include "caravan/core/exceptions.h"
+#include "caravan/core/random.h"
 
 class Game {
 protected:
+    GameState state;
     Table *table_ptr{};
     Player *pa_ptr{};
     Player *pb_ptr{};
-    Player *p_turn;
+    uint64_t version{0};  // bumped by every change made through the game
     bool closed;
 
+    // Kept up to date by every change made through the game
+    std::array<int8_t, PLAYER_CARAVANS_MAX> bids_compared{};  // A-D, B-E, C-F
+    PlayerName winner{NO_PLAYER};
+
     int8_t compare_bids(CaravanName cvname1, CaravanName cvname2);
 
+    PlayerName find_winner();
+
+    void update_bids(uint8_t i_pair);
+
+    void update_winner(GameCommand *command);
+
     CaravanName winning_bid(CaravanName cvname1, CaravanName cvname2);
 
     bool has_sold(CaravanName cvname);
@@ -28,11 +41,25 @@ protected:
 
     void option_discard(Player *pptr, GameCommand *command);
 
-    void option_play(Player *pptr, GameCommand *command);
+    void option_play(Player *pptr, GameCommand *command, GameUndo *undo);
+
+    void record_removed(GameUndo *undo, GameCommand *command, Card c_hand);
 
 public:
     explicit Game(GameConfig *gc);
 
+    explicit Game(GameState *gs);
+
+    Game(const Game &) = delete;
+
+    Game &operator=(const Game &) = delete;
+
+    GameState clone();
+
+    void determinize(PlayerName viewer, Random *rng);
+
+    void restore(GameState *gs);
+
     static CaravanName get_opposite_caravan_name(CaravanName cvname);
 
     void close();
@@ -45,6 +72,10 @@ public:
 
     bool is_caravan_bust(CaravanName cvname);
 
+    uint64_t get_hash();
+
+    uint64_t get_version();
+
     PlayerName get_player_turn();
 
     Table *get_table();
@@ -53,7 +84,26 @@ public:
 
     bool is_closed();
 
+    bool is_legal(GameCommand *command);
+
+    void legal_moves(PlayerName pname, GameCommandList *moves);
+
     void play_option(GameCommand *command);
+
+    void play_option(GameCommand *command, GameUndo *undo);
+
+    void unplay(GameUndo *undo);
+
+    // Unchecked accessors for the engine, as on Caravan
+
+    Player *player(PlayerName pname) {
+        assert(!closed and (pname == PLAYER_ABC or pname == PLAYER_DEF));
+        return pname == PLAYER_ABC ? pa_ptr : pb_ptr;
+    }
+
+    PlayerName player_turn() const { assert(!closed); return state.p_turn; }
+
+    Table *table() { assert(!closed); return table_ptr; }
 };
 
 #endif //CARAVAN_MODEL_GAME_H
@@ -6,23 +6,35 @@
 #define CARAVAN_MODEL_PLAYER_H
 
 #include <array>
+#include <cassert>
 #include "caravan/model/deck.h"
 
 
 class Player {
 protected:
     PlayerName name;
-    Deck *deck;
-    Hand hand;
-    uint8_t i_hand;
-    uint16_t moves;
+    PlayerState *ps;
     bool closed;
 
+    void deal();
+
+    void draw_card();
+
 public:
-    explicit Player(PlayerName pn, Deck *d);
+    explicit Player(PlayerName pn, PlayerState *state, Deck *d);
+
+    explicit Player(PlayerName pn, PlayerState *state, uint8_t size_deck);
+
+    explicit Player(PlayerName pn, PlayerState *state);
+
+    Player(const Player &) = delete;
+
+    Player &operator=(const Player &) = delete;
 
     void close();
 
+    Card get_from_deck_at(uint8_t pos);
+
     Card get_from_hand_at(uint8_t pos);
 
     Hand get_hand();
@@ -40,6 +52,18 @@ public:
     void maybe_add_card_to_hand();
 
     Card discard_from_hand_at(uint8_t pos);
+
+    void swap_with_deck_top(uint8_t pos);
+
+    // Unchecked accessors for the engine, as on Caravan
+
+    const Hand &hand() const { assert(!closed); return ps->hand; }
+
+    uint16_t moves_count() const { assert(!closed); return ps->moves; }
+
+    uint8_t size_deck() const { assert(!closed); return ps->i_deck; }
+
+    uint8_t size_hand() const { assert(!closed); return ps->i_hand; }
 };
 
 #endif //CARAVAN_MODEL_PLAYER_H
@@ -6,24 +6,22 @@
 #define CARAVAN_MODEL_TABLE_H
 
 #include <array>
+#include <cassert>
 #include <cstdint>
 #include "caravan/model/caravan.h"
 
 
 class Table {
 protected:
-    Caravan *a = new Caravan(CARAVAN_A);
-    Caravan *b = new Caravan(CARAVAN_B);
-    Caravan *c = new Caravan(CARAVAN_C);
-    Caravan *d = new Caravan(CARAVAN_D);
-    Caravan *e = new Caravan(CARAVAN_E);
-    Caravan *f = new Caravan(CARAVAN_F);
-
-    std::array<Caravan *, TABLE_CARAVANS_MAX> caravans = {a, b, c, d, e, f};
+    std::array<Caravan, TABLE_CARAVANS_MAX> caravans;  // CARAVAN_A first
     bool closed;
 
 public:
-    explicit Table();
+    explicit Table(TableState *state);
+
+    Table(const Table &) = delete;
+
+    Table &operator=(const Table &) = delete;
 
     void close();
 
@@ -31,9 +29,17 @@ public:
 
     void clear_caravan(CaravanName cvname);
 
+    bool can_play_face_card(CaravanName cvname, Card card, uint8_t pos);
+
     void play_face_card(CaravanName cvname, Card card, uint8_t pos);
 
     void play_numeral_card(CaravanName cvname, Card card);
+
+    // Unchecked accessor for the engine, as on Caravan
+    Caravan *caravan(CaravanName cvname) {
+        assert(!closed and cvname >= CARAVAN_A and cvname <= CARAVAN_F);
+        return &caravans[cvname - CARAVAN_A];
+    }
 };
 
 #endif //CARAVAN_MODEL_TABLE_H
@@ -0,0 +1,137 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_CFR_H
+#define CARAVAN_USER_BOT_CFR_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "caravan/user/user.h"
+
+const std::string CFR_STRATEGY_DEFAULT = "caravan.cfr";
+const uint8_t CFR_TABLE_BITS_DEFAULT = 22;
+const uint8_t CFR_TABLE_BITS_MAX = 32;
+const double CFR_EXPLORATION_DEFAULT = 0.6;
+
+/*
+ * ABSTRACTION
+ */
+
+// Moves are grouped into actions, and each action is played as its best
+// move by score_move
+enum CfrAction : uint8_t {
+    CFR_NUMERAL_A,  // a numeral on the player's first caravan
+    CFR_NUMERAL_B,
+    CFR_NUMERAL_C,
+    CFR_KING_MINE,
+    CFR_KING_THEIRS,
+    CFR_JACK_MINE,
+    CFR_JACK_THEIRS,
+    CFR_QUEEN_MINE,
+    CFR_QUEEN_THEIRS,
+    CFR_JOKER,
+    CFR_DISCARD,
+    CFR_CLEAR,
+    CFR_ACTIONS
+};
+
+typedef std::array<GameCommand, CFR_ACTIONS> CfrMoves;
+typedef std::array<float, CFR_ACTIONS> CfrStrategy;
+typedef std::unordered_map<uint64_t, CfrStrategy> CfrStrategies;
+
+uint64_t cfr_info_key(Game *game, PlayerName pname);
+
+uint16_t cfr_actions(Game *game, PlayerName pname, CfrMoves *moves);
+
+/*
+ * TRAINING
+ */
+
+typedef struct CfrEntry {
+    std::atomic<uint64_t> key{0};  // 0 if unused
+    std::array<std::atomic<float>, CFR_ACTIONS> regret{};
+    std::array<std::atomic<float>, CFR_ACTIONS> strategy{};  // weighted sum of policies
+} CfrEntry;
+
+typedef struct CfrStep {
+    CfrEntry *entry{nullptr};  // nullptr if the table is full
+    PlayerName player{NO_PLAYER};
+    uint16_t legal{0};  // bit per available action
+    uint8_t action{0};
+    CfrStrategy policy{};
+    double prob_sample{1};  // chance that the action was sampled
+    double reach_other{1};  // chance that the player not being updated got here
+    double reach_sample{1};  // chance that the sampled moves got here
+} CfrStep;
+
+double cfr_update(CfrStep *step, PlayerName update, double value);
+
+class CfrTable {
+protected:
+    CfrEntry *entries;
+    uint64_t capacity;
+    std::atomic<uint64_t> size{0};
+    bool closed;
+
+public:
+    explicit CfrTable(uint8_t bits);
+
+    CfrTable(const CfrTable &) = delete;
+
+    CfrTable &operator=(const CfrTable &) = delete;
+
+    void close();
+
+    CfrEntry *find(uint64_t key, bool insert);
+
+    uint64_t get_capacity();
+
+    uint64_t get_size();
+
+    void save(std::string path);
+};
+
+class CfrTrainer {
+protected:
+    CfrTable *table;
+    GameConfig config;
+    double exploration;
+    std::atomic<uint64_t> next_iteration{0};
+
+    void run_iteration(uint64_t i_iteration, Random *rng, std::vector<CfrStep> *steps);
+
+    void run_worker(uint64_t iterations, uint64_t seed);
+
+public:
+    explicit CfrTrainer(
+        CfrTable *t,
+        GameConfig *gc,
+        double epsilon = CFR_EXPLORATION_DEFAULT);
+
+    void train(uint64_t iterations, uint8_t threads, uint64_t seed);
+};
+
+/*
+ * BOT
+ */
+
+class UserBotCfr : public UserBot {
+protected:
+    Random rng;
+    std::shared_ptr<const CfrStrategies> strategies;  // shared by every bot using the same file
+
+public:
+    explicit UserBotCfr(
+        PlayerName pn,
+        std::string path = CFR_STRATEGY_DEFAULT,
+        uint64_t seed = 0);
+
+    void close() override;
+    GameCommand request_command(Game *game) override;
+};
+
+#endif //CARAVAN_USER_BOT_CFR_H
@@ -0,0 +1,39 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_EXPECTIMAX_H
+#define CARAVAN_USER_BOT_EXPECTIMAX_H
+
+#include "caravan/user/user.h"
+
+const uint8_t EXPECTIMAX_DEPTH_DEFAULT = 6;
+const uint8_t EXPECTIMAX_DEPTH_HEADLESS = 3;  // depth 4 takes seconds a move without a deadline
+const uint32_t EXPECTIMAX_MILLIS_DEFAULT = 1000;
+const uint8_t EXPECTIMAX_SAMPLES_DEFAULT = 4;
+const uint8_t EXPECTIMAX_WIDTH_DEFAULT = 8;
+
+class UserBotExpectimax : public UserBot {
+protected:
+    Random rng;
+    uint8_t max_depth;
+    uint32_t max_millis;
+    uint8_t num_samples;
+    uint8_t width;
+
+public:
+    explicit UserBotExpectimax(
+        PlayerName pn,
+        uint8_t depth = EXPECTIMAX_DEPTH_DEFAULT,
+        uint32_t millis = EXPECTIMAX_MILLIS_DEFAULT,
+        uint8_t samples = EXPECTIMAX_SAMPLES_DEFAULT,
+        uint8_t moves = EXPECTIMAX_WIDTH_DEFAULT,
+        uint64_t seed = 0);
+
+    void close() override;
+    GameCommand request_command(Game *game) override;
+};
+
+double expectimax_value(Game *game, PlayerName me, uint8_t depth, uint8_t width, bool prune);
+
+#endif //CARAVAN_USER_BOT_EXPECTIMAX_H
@@ -10,7 +10,9 @@
 class BotFactory {
 public:
     BotFactory() = delete;
-    static UserBot *get(std::string name, PlayerName player_name);
+    static UserBot *get(
+        std::string name, PlayerName player_name,
+        uint64_t seed = 0, bool headless = false);
 };
 
 #endif //CARAVAN_USER_BOT_FACTORY_H
@@ -0,0 +1,31 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_FEATURES_H
+#define CARAVAN_USER_BOT_FEATURES_H
+
+#include <array>
+#include "caravan/model/game.h"
+
+// Every numeral slot: present, value, suit (4) and kings
+const uint16_t FEATURES_SLOT = 7;
+
+// Every caravan: bid, sold, bust, winning, size, direction (3) and suit (4)
+const uint16_t FEATURES_CARAVAN =
+    FEATURES_SLOT * TRACK_NUMERIC_MAX + 12;
+
+// The player's hand: count of each rank (14) and of each suit (4)
+const uint16_t FEATURES_HAND = 18;
+
+// Both players: deck size, hand size, moves, in start round; then own turn
+const uint16_t FEATURES_COUNTS = 9;
+
+const uint16_t FEATURES_SIZE =
+    FEATURES_CARAVAN * TABLE_CARAVANS_MAX + FEATURES_HAND + FEATURES_COUNTS;
+
+typedef std::array<float, FEATURES_SIZE> Features;
+
+void encode_features(Game *game, PlayerName pname, Features *features);
+
+#endif //CARAVAN_USER_BOT_FEATURES_H
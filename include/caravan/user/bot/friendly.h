@@ -11,7 +11,7 @@ class UserBotFriendly : public UserBotNormal {
 public:
     explicit UserBotFriendly(PlayerName pn) : UserBotNormal(pn){};
 
-    std::string request_move(Game *game) override;
+    GameCommand request_command(Game *game) override;
 };
 
 #endif //CARAVAN_USER_BOT_FRIENDLY_H
@@ -0,0 +1,12 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_HEURISTIC_H
+#define CARAVAN_USER_BOT_HEURISTIC_H
+
+#include "caravan/model/game.h"
+
+int16_t score_move(Game *game, PlayerName pname, GameCommand *command);
+
+#endif //CARAVAN_USER_BOT_HEURISTIC_H
@@ -0,0 +1,73 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_ISMCTS_H
+#define CARAVAN_USER_BOT_ISMCTS_H
+
+#include <thread>
+#include <vector>
+#include "caravan/user/user.h"
+
+const uint32_t ISMCTS_ITERATIONS_DEFAULT = 4000;
+const uint32_t ISMCTS_MILLIS_DEFAULT = 1000;
+const uint32_t ISMCTS_THREADS_MAX = 256;
+const double ISMCTS_EXPLORATION = 0.7;
+const uint32_t ISMCTS_PONDER_ITERATIONS_MAX = 200000;  // bounds the tree's memory
+
+typedef struct IsmctsNode {
+    GameCommand move{};  // pos_hand is unused, as it differs between determinizations
+    PlayerName mover{NO_PLAYER};
+    uint32_t visits{0};
+    uint32_t avail{0};
+    double reward{0};
+    IsmctsNode *parent{nullptr};
+    std::vector<IsmctsNode *> children;
+} IsmctsNode;
+
+struct IsmctsShared;
+
+class UserBotIsmcts : public UserBot {
+protected:
+    Random rng;
+    uint32_t max_iterations;
+    uint32_t max_millis;
+    uint32_t num_threads;
+
+    // One tree per thread, kept between moves
+    std::vector<IsmctsNode *> trees;
+    GameState last_state{};
+    GameCommand last_move{};
+    bool has_last{false};
+    bool pondered{false};  // trees already follow last_move, from last_state
+
+    // Search during the opponent's turn
+    uint32_t ponder_iterations{ISMCTS_PONDER_ITERATIONS_MAX};
+    IsmctsShared *ponder_shared{nullptr};
+    std::vector<std::thread> ponder_workers;
+
+    void follow_own_move(Game *game);
+
+    void reuse_trees(Game *game);
+
+    void delete_trees();
+
+    void stop_pondering();
+
+public:
+    explicit UserBotIsmcts(
+        PlayerName pn,
+        uint32_t iterations = ISMCTS_ITERATIONS_DEFAULT,
+        uint32_t millis = ISMCTS_MILLIS_DEFAULT,
+        uint32_t threads = 0,
+        uint64_t seed = 0);
+
+    ~UserBotIsmcts() override;
+
+    void close() override;
+    GameCommand request_command(Game *game) override;
+    void ponder_start(Game *game) override;
+    void ponder_stop() override;
+};
+
+#endif //CARAVAN_USER_BOT_ISMCTS_H
@@ -0,0 +1,36 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_MONTECARLO_H
+#define CARAVAN_USER_BOT_MONTECARLO_H
+
+#include "caravan/user/user.h"
+
+const uint32_t MONTECARLO_PLAYOUTS_DEFAULT = 2000;
+const uint32_t MONTECARLO_MILLIS_DEFAULT = 1000;
+const uint32_t MONTECARLO_THREADS_MAX = 256;
+
+class UserBotMonteCarlo : public UserBot {
+protected:
+    Random rng;
+    uint32_t max_playouts;
+    uint32_t max_millis;
+    uint32_t num_threads;
+    bool normal_playouts;
+    uint32_t last_playouts{0};  // playouts in the last move decision
+
+public:
+    explicit UserBotMonteCarlo(
+        PlayerName pn,
+        uint32_t playouts = MONTECARLO_PLAYOUTS_DEFAULT,
+        uint32_t millis = MONTECARLO_MILLIS_DEFAULT,
+        uint32_t threads = 0,
+        bool normal = true,
+        uint64_t seed = 0);
+
+    void close() override;
+    GameCommand request_command(Game *game) override;
+};
+
+#endif //CARAVAN_USER_BOT_MONTECARLO_H
@@ -0,0 +1,81 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_NEURAL_H
+#define CARAVAN_USER_BOT_NEURAL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "caravan/user/user.h"
+#include "caravan/user/bot/features.h"
+
+const std::string NEURAL_WEIGHTS_DEFAULT = "caravan.nn";
+const uint32_t NEURAL_LAYERS_MAX = 16;
+const uint32_t NEURAL_WIDTH_MAX = 1024;
+const uint32_t NEURAL_LANES = 8;  // floats in an AVX2 register
+
+enum NeuralKernel : uint8_t {
+    NEURAL_SCALAR,
+    NEURAL_SSE,
+    NEURAL_AVX2
+};
+
+typedef struct NeuralLayer {
+    uint32_t size_in{0};
+    uint32_t size_out{0};
+    uint32_t stride{0};  // size_out rounded up to whole AVX2 registers
+    std::vector<float> weights;  // a row of stride per input
+    std::vector<float> biases;  // stride, zero past size_out
+} NeuralLayer;
+
+/**
+ * A small multilayer perceptron that scores a player's view of a game:
+ * hidden layers use ReLU and a single tanh output gives the value for the
+ * player, from -1 (a loss) to 1 (a win).
+ */
+class NeuralNet {
+protected:
+    std::vector<NeuralLayer> layers;
+    NeuralKernel kernel;
+    bool closed;
+
+    void add_layer(uint32_t size_in, uint32_t size_out);
+
+public:
+    explicit NeuralNet(std::string path);
+
+    explicit NeuralNet(std::vector<uint32_t> sizes_hidden, uint64_t seed);
+
+    NeuralNet(const NeuralNet &) = delete;
+
+    NeuralNet &operator=(const NeuralNet &) = delete;
+
+    void close();
+
+    float evaluate(const Features *features) const;
+
+    NeuralKernel get_kernel();
+
+    void set_kernel(NeuralKernel k);
+
+    void save(std::string path);
+
+    static bool supports(NeuralKernel k);
+};
+
+class UserBotNeural : public UserBot {
+protected:
+    std::shared_ptr<const NeuralNet> net;  // shared by every bot using the same file
+
+public:
+    explicit UserBotNeural(
+        PlayerName pn,
+        std::string path = NEURAL_WEIGHTS_DEFAULT);
+
+    void close() override;
+    GameCommand request_command(Game *game) override;
+};
+
+#endif //CARAVAN_USER_BOT_NEURAL_H
@@ -9,12 +9,12 @@
 
 class UserBotNormal : public UserBot {
 protected:
-    std::string generate_move(Game *game, bool allow_numeral, bool allow_face, bool allow_clear);
+    GameCommand generate_move(Game *game, bool allow_numeral, bool allow_face, bool allow_clear);
 public:
     explicit UserBotNormal(PlayerName pn) : UserBot(pn){};
 
     void close() override;
-    std::string request_move(Game *game) override;
+    GameCommand request_command(Game *game) override;
 };
 
 #endif //CARAVAN_USER_BOT_NORMAL_H
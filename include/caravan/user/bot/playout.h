@@ -0,0 +1,14 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_PLAYOUT_H
+#define CARAVAN_USER_BOT_PLAYOUT_H
+
+#include "caravan/user/user.h"
+
+const uint16_t PLAYOUT_MOVES_MAX = 1000;
+
+PlayerName playout(Game *game, Random *rng, UserBot *bot_abc, UserBot *bot_def);
+
+#endif //CARAVAN_USER_BOT_PLAYOUT_H
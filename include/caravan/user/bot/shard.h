@@ -0,0 +1,119 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_USER_BOT_SHARD_H
+#define CARAVAN_USER_BOT_SHARD_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include "caravan/user/bot/features.h"
+
+const uint32_t SHARD_MAGIC = 0x31485343;  // "CSH1"
+const uint32_t SHARD_VERSION = 1;
+const uint32_t SHARD_BYTE_ORDER = 0x01020304;
+const uint64_t SHARD_RECORDS_DEFAULT = 100000;
+const std::string SHARD_EXTENSION = ".shard";
+
+/*
+ * A shard is a header followed by fixed-size records, both in the native
+ * byte order of the machine that wrote them, so that it can be memory-mapped
+ * and indexed directly: record i starts at size_header + i * size_record.
+ * The header's byte_order holds SHARD_BYTE_ORDER, so a reader can tell which
+ * order that was from the first of its bytes (0x04 for little-endian).
+ *
+ * The version changes whenever the layout of a record changes, even if its
+ * size does not.
+ *
+ * The move played is stored as one byte per field, with no bitfields, so
+ * that the layout does not depend on the compiler:
+ *
+ *   option        OptionType of the move
+ *   pos_hand      position of the card in the hand, from 1
+ *   caravan_name  CaravanName of the caravan played on, or 0
+ *   pos_caravan   position of the card in the caravan, from 1, or 0
+ *   hand_rank     Rank and Suit of the card played or discarded
+ *   hand_suit
+ *   board_rank    Rank and Suit of the card played on, or a suit of
+ *   board_suit    NO_SUIT when the move was not played on a card
+ */
+
+typedef struct ShardHeader {
+    uint32_t magic{SHARD_MAGIC};
+    uint32_t size_header{0};
+    uint32_t size_record{0};
+    uint32_t size_features{FEATURES_SIZE};
+    uint64_t records{0};  // written when the shard is finished
+    uint32_t version{SHARD_VERSION};
+    uint32_t byte_order{SHARD_BYTE_ORDER};
+    std::array<uint8_t, 32> reserved{};
+} ShardHeader;
+
+typedef struct ShardRecord {
+    Features features{};  // view of the player to move, before the move
+    uint8_t option{NO_OPTION};  // the move played, see above
+    uint8_t pos_hand{0};
+    uint8_t caravan_name{NO_CARAVAN};
+    uint8_t pos_caravan{0};
+    uint8_t hand_rank{0};
+    uint8_t hand_suit{NO_SUIT};
+    uint8_t board_rank{0};
+    uint8_t board_suit{NO_SUIT};
+    PlayerName player{NO_PLAYER};  // player to move
+    PlayerName winner{NO_PLAYER};  // who went on to win the game
+    uint16_t move{0};  // index of the move in its game
+} ShardRecord;
+
+static_assert(sizeof(ShardHeader) == 64);
+static_assert(offsetof(ShardHeader, records) == 16);
+static_assert(offsetof(ShardHeader, version) == 24);
+static_assert(offsetof(ShardHeader, byte_order) == 28);
+static_assert(std::is_trivially_copyable_v<ShardRecord>);
+static_assert(sizeof(ShardRecord) % alignof(float) == 0);
+
+// A change to any of these is a change to the format: bump SHARD_VERSION
+static_assert(sizeof(ShardRecord) == 1752);
+static_assert(offsetof(ShardRecord, option) == 1740);
+static_assert(offsetof(ShardRecord, board_suit) == 1747);
+static_assert(offsetof(ShardRecord, player) == 1748);
+static_assert(offsetof(ShardRecord, winner) == 1749);
+static_assert(offsetof(ShardRecord, move) == 1750);
+
+class ShardWriter {
+protected:
+    std::string prefix;
+    uint64_t records_max;
+    std::ofstream out;
+    ShardHeader header;
+    uint32_t shards;
+    uint64_t records;
+    bool closed;
+
+    void finish_shard();
+    void open_shard();
+
+public:
+    explicit ShardWriter(
+        std::string path_prefix,
+        uint64_t records_per_shard = SHARD_RECORDS_DEFAULT);
+
+    ShardWriter(const ShardWriter &) = delete;
+
+    ShardWriter &operator=(const ShardWriter &) = delete;
+
+    void close();
+
+    uint64_t get_records();
+
+    uint32_t get_shards();
+
+    static std::string shard_path(std::string path_prefix, uint32_t index);
+
+    void write(const ShardRecord *record, uint64_t count);
+};
+
+void encode_command(GameCommand *command, ShardRecord *record);
+
+#endif //CARAVAN_USER_BOT_SHARD_H
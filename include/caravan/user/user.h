@@ -8,6 +8,9 @@
 #include "caravan/core/common.h"
 #include "caravan/model/game.h"
 
+// What a bot plays when it has no better move
+const GameCommand BOT_DISCARD_FIRST = {OPTION_DISCARD, HAND_POS_MIN};
+
 class User {
 protected:
     PlayerName name;
@@ -22,6 +25,9 @@ public:
     virtual void close() = 0;
     virtual bool is_human() = 0;
     virtual std::string request_move(Game *game) = 0;
+    virtual GameCommand request_command(Game *game) = 0;
+    virtual void ponder_start(Game *game) = 0;
+    virtual void ponder_stop() = 0;
 };
 
 class UserHuman : public User {
@@ -31,6 +37,9 @@ public:
     void close() override { closed = true; }
     bool is_human() override { return true; }
     std::string request_move(Game *game) override { return {}; }
+    GameCommand request_command(Game *game) override { return {}; }
+    void ponder_start(Game *game) override {}
+    void ponder_stop() override {}
 };
 
 class UserBot : public User {
@@ -39,7 +48,18 @@ public:
 
     void close() override { closed = true; }
     bool is_human() override { return false; }
-    std::string request_move(Game *game) override { return {}; }
+    GameCommand request_command(Game *game) override { return {}; }
+
+    // Bots that keep their search between moves can also search during the
+    // opponent's turn; request_command stops any such search
+    void ponder_start(Game *game) override {}
+    void ponder_stop() override {}
+
+    // Bots choose a command directly, and only format it for display
+    std::string request_move(Game *game) override {
+        GameCommand command = request_command(game);
+        return format_command(&command);
+    }
 };
 
 #endif //CARAVAN_USER_H
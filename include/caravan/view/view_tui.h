@@ -5,8 +5,98 @@
 #ifndef CARAVAN_VIEW_TUI_H
 #define CARAVAN_VIEW_TUI_H
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "caravan/view/view.h"
 #include "caravan/core/common.h"
+#include "ftxui/component/screen_interactive.hpp"
+
+const int16_t VIEW_NO_HIGHLIGHT = -1;
+
+/**
+ * A generated element, kept until the game or its highlight changes.
+ */
+typedef struct ViewCached {
+    ftxui::Element element{nullptr};
+    uint64_t version{0};
+    int16_t highlight{VIEW_NO_HIGHLIGHT};
+} ViewCached;
+
+typedef struct ViewCache {
+    std::array<ViewCached, TABLE_CARAVANS_MAX> caravans{};
+    std::array<ViewCached, 2> decks{};  // top (PLAYER_DEF), then bottom (PLAYER_ABC)
+} ViewCache;
+
+/**
+ * Wakes a screen with a single custom event once a delay has passed, so that
+ * a view waiting on the clock sleeps instead of redrawing on every frame.
+ */
+class ViewTimer {
+protected:
+    ftxui::ScreenInteractive *screen;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::chrono::steady_clock::time_point deadline;
+    bool pending;
+    bool closed;
+    std::thread thread;
+
+    void run();
+
+public:
+    explicit ViewTimer(ftxui::ScreenInteractive *s);
+
+    ViewTimer(const ViewTimer &) = delete;
+
+    ViewTimer &operator=(const ViewTimer &) = delete;
+
+    void close();
+
+    void wake_in(uint64_t millis);
+};
+
+enum ViewBotState : uint8_t {
+    BOT_IDLE,
+    BOT_RUNNING,
+    BOT_DONE
+};
+
+/**
+ * Asks a bot for its command on a separate thread, against a snapshot of the
+ * game, so that a slow bot does not hold up input or resizing. The screen is
+ * woken with a custom event once the command is ready to be taken.
+ */
+class ViewBotTask {
+protected:
+    ftxui::ScreenInteractive *screen;
+    std::mutex mutex;
+    GameState snapshot;  // only touched by the worker while running
+    GameCommand command;
+    std::string msg_error;
+    ViewBotState state;
+    bool closed;
+    std::thread thread;
+
+    void run(User *bot);
+
+public:
+    explicit ViewBotTask(ftxui::ScreenInteractive *s);
+
+    ViewBotTask(const ViewBotTask &) = delete;
+
+    ViewBotTask &operator=(const ViewBotTask &) = delete;
+
+    void close();
+
+    bool is_idle();
+
+    void start(User *bot, Game *game);
+
+    bool take(GameCommand *out);
+};
 
 class ViewTUI : public View {
 protected:
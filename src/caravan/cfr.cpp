@@ -0,0 +1,172 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <chrono>
+#include "cxxopts.hpp"
+#include "caravan/user/bot/cfr.h"
+
+const std::string OPTS_HELP = "h,help";
+const std::string OPTS_VERSION = "v,version";
+const std::string OPTS_ITERATIONS = "n,iterations";
+const std::string OPTS_THREADS = "t,threads";
+const std::string OPTS_OUTPUT = "o,output";
+const std::string OPTS_BITS = "b,bits";
+const std::string OPTS_EXPLORATION = "e,exploration";
+const std::string OPTS_FIRST = "f,first";
+const std::string OPTS_CARDS = "c,cards";
+const std::string OPTS_SAMPLES = "s,samples";
+const std::string OPTS_IMBALANCED = "i,imbalanced";
+const std::string OPTS_SEED = "seed";
+
+const std::string KEY_HELP = "help";
+const std::string KEY_VERSION = "version";
+const std::string KEY_ITERATIONS = "iterations";
+const std::string KEY_THREADS = "threads";
+const std::string KEY_OUTPUT = "output";
+const std::string KEY_BITS = "bits";
+const std::string KEY_EXPLORATION = "exploration";
+const std::string KEY_FIRST = "first";
+const std::string KEY_CARDS = "cards";
+const std::string KEY_SAMPLES = "samples";
+const std::string KEY_IMBALANCED = "imbalanced";
+const std::string KEY_SEED = "seed";
+
+const uint8_t FIRST_ABC = 1;
+const uint8_t FIRST_DEF = 2;
+
+int main(int argc, char *argv[]) {
+    GameConfig gc;
+    uint64_t iterations;
+    uint8_t threads;
+    std::string output;
+    uint8_t bits;
+    double exploration;
+    uint64_t seed;
+
+    try {
+        cxxopts::Options options(std::string(CARAVAN_NAME) + "-cfr");
+
+        options.add_options()
+            (OPTS_HELP, "Print help instructions.")
+            (OPTS_VERSION, "Print Caravan version.")
+            (OPTS_ITERATIONS, "Number of self-play games to train on.", cxxopts::value<uint64_t>()->default_value("1000000"))
+            (OPTS_THREADS, "Number of worker threads (0 uses all cores).", cxxopts::value<uint8_t>()->default_value("0"))
+            (OPTS_OUTPUT, "Strategy file to write.", cxxopts::value<std::string>()->default_value(CFR_STRATEGY_DEFAULT))
+            (OPTS_BITS, "The strategy table holds 2^bits information sets of about 100 bytes each (1-32, inclusive).", cxxopts::value<uint8_t>()->default_value(std::to_string(CFR_TABLE_BITS_DEFAULT)))
+            (OPTS_EXPLORATION, "How often training explores a random action (0-1, inclusive).", cxxopts::value<double>()->default_value(std::to_string(CFR_EXPLORATION_DEFAULT)))
+            (OPTS_FIRST, "Which player goes first (1 or 2).", cxxopts::value<uint8_t>()->default_value("1"))
+            (OPTS_CARDS, "Number of cards for each caravan deck (30-162, inclusive).", cxxopts::value<uint8_t>()->default_value("54"))
+            (OPTS_SAMPLES, "Number of traditional decks to sample when building caravan decks (1-3, inclusive).", cxxopts::value<uint8_t>()->default_value("1"))
+            (OPTS_IMBALANCED,
+             "An imbalanced caravan deck is built by taking as many "
+             "cards from one shuffled sample deck before moving to the next. "
+             "A balanced deck randomly samples cards across all sample decks.")
+            (OPTS_SEED, "Seed for the first thread, with each later thread using the next seed (0 is random).", cxxopts::value<uint64_t>()->default_value("0"))
+        ;
+
+        auto result = options.parse(argc, argv);
+
+        // Print help instructions.
+        if (result.count(KEY_HELP)) {
+            printf("%s-cfr v%s\n\n", CARAVAN_NAME, CARAVAN_VERSION);
+            printf("Trains a strategy for the cfr bot by self-play.\n");
+            printf("%s\n", CARAVAN_COPYRIGHT);
+            printf("%s\n", CARAVAN_URL);
+            printf("%s", options.help().c_str());
+            exit(EXIT_SUCCESS);
+        }
+
+        if (result.count(KEY_VERSION)) {
+            printf("%s\n", CARAVAN_VERSION);
+            exit(EXIT_SUCCESS);
+        }
+
+        iterations = result[KEY_ITERATIONS].as<uint64_t>();
+        threads = result[KEY_THREADS].as<uint8_t>();
+        output = result[KEY_OUTPUT].as<std::string>();
+        bits = result[KEY_BITS].as<uint8_t>();
+        exploration = result[KEY_EXPLORATION].as<double>();
+        uint8_t first = result[KEY_FIRST].as<uint8_t>();
+        uint8_t cards = result[KEY_CARDS].as<uint8_t>();
+        uint8_t samples = result[KEY_SAMPLES].as<uint8_t>();
+        bool imbalanced = result[KEY_IMBALANCED].as<bool>();
+        seed = result[KEY_SEED].as<uint64_t>();
+
+        if (iterations == 0) {
+            printf("Number of iterations must be at least 1.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (bits == 0 || bits > CFR_TABLE_BITS_MAX) {
+            printf("Table bits must be between 1 and %d (inclusive).\n", CFR_TABLE_BITS_MAX);
+            exit(EXIT_FAILURE);
+        }
+
+        if (exploration < 0 || exploration > 1) {
+            printf("Exploration must be between 0 and 1 (inclusive).\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if(first < FIRST_ABC || first > FIRST_DEF) {
+            printf("First player must be either %d or %d.\n", FIRST_ABC, FIRST_DEF);
+            exit(EXIT_FAILURE);
+        }
+
+        if (cards < DECK_CARAVAN_MIN || cards > DECK_CARAVAN_MAX) {
+            printf("Caravan decks must have between %d and %d cards (inclusive).\n", DECK_CARAVAN_MIN, DECK_CARAVAN_MAX);
+            exit(EXIT_FAILURE);
+        }
+
+        if (samples < SAMPLE_DECKS_MIN || samples > SAMPLE_DECKS_MAX) {
+            printf("Number of caravan deck samples must be between %d and %d (inclusive).\n", SAMPLE_DECKS_MIN, SAMPLE_DECKS_MAX);
+            exit(EXIT_FAILURE);
+        }
+
+        gc = {
+            cards, samples, !imbalanced,
+            cards, samples, !imbalanced,
+            first == FIRST_ABC ? PLAYER_ABC : PLAYER_DEF
+        };
+
+    } catch (CaravanException &e) {
+        printf("%s\n", e.what().c_str());
+        exit(EXIT_FAILURE);
+
+    } catch (std::exception &e) {
+        printf("%s\n", e.what());
+        exit(EXIT_FAILURE);
+    }
+
+    CfrTable table{bits};
+    CfrTrainer trainer{&table, &gc, exploration};
+    auto time_start = std::chrono::steady_clock::now();
+
+    try {
+        trainer.train(iterations, threads, seed);
+        table.save(output);
+
+    } catch (CaravanException &e) {
+        printf("%s\n", e.what().c_str());
+        table.close();
+        exit(EXIT_FAILURE);
+    }
+
+    auto time_end = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(time_end - time_start).count();
+
+    printf("Iterations:  %llu\n", (unsigned long long) iterations);
+
+    if (seed != 0) {
+        printf("Seed:        %llu\n", (unsigned long long) seed);
+    }
+
+    printf("Info sets:   %llu of %llu\n",
+           (unsigned long long) table.get_size(),
+           (unsigned long long) table.get_capacity());
+    printf("Time:        %.3f s\n", secs);
+    printf("Iter/sec:    %.1f\n", secs > 0 ? iterations / secs : 0.0);
+    printf("Output:      %s\n", output.c_str());
+
+    table.close();
+}
@@ -5,56 +5,326 @@
 #include "caravan/core/common.h"
 #include "caravan/core/exceptions.h"
 
-bool is_numeral_card(Card c) {
-    return (c.rank >= ACE and c.rank <= TEN);
+std::string caravan_letter(CaravanName caravan_name) {
+    return caravan_name < CARAVAN_LETTER.size() ? CARAVAN_LETTER[caravan_name] : "";
 }
 
-bool is_face_card(Card c) {
-    return (c.rank >= JACK and c.rank <= JOKER);
+/**
+ * @throws CaravanFatalException Card is not a numeral.
+ */
+uint8_t numeral_rank_value(Card c) {
+    if (!is_numeral_card(c)) {
+        throw CaravanFatalException("Card is not a numeral.");
+    }
+
+    return card_value(c);
 }
 
-std::string caravan_letter(CaravanName caravan_name) {
-    switch (caravan_name) {
-        case CARAVAN_A:
-            return "A";
-        case CARAVAN_B:
-            return "B";
-        case CARAVAN_C:
-            return "C";
-        case CARAVAN_D:
-            return "D";
-        case CARAVAN_E:
-            return "E";
-        case CARAVAN_F:
-            return "F";
+void process_first(std::string input, GameCommand *command) {
+    char c = input.at(0);  // minimum input size already checked elsewhere
+
+    switch (c) {
+        case 'P':
+        case 'p':
+            command->option = OPTION_PLAY;
+            /*
+             * P2F
+             * "Play numeral card at hand pos 2 onto caravan F"
+             *
+             * P4F8
+             * "Play face card at hand pos 4 onto caravan F, slot 8"
+             */
+            break;
+
+        case 'D':
+        case 'd':
+            command->option = OPTION_DISCARD;
+            /*
+             * D3
+             * "Discard card at hand pos 3"
+             */
+            break;
+
+        case 'C':
+        case 'c':
+            /*
+             * CE
+             * "Clear caravan E"
+             */
+            command->option = OPTION_CLEAR;
+            break;
+
         default:
-            return "";
+            throw CaravanInputException(
+                "Invalid option '" + std::string(1, c) + "', must be one of: (P)lay, (D)iscard, (C)lear.");
     }
 }
 
-uint8_t numeral_rank_value(Card c) {
-    switch (c.rank) {
-        case ACE:
-            return 1;
-        case TWO:
-            return 2;
-        case THREE:
-            return 3;
-        case FOUR:
-            return 4;
-        case FIVE:
-            return 5;
-        case SIX:
-            return 6;
-        case SEVEN:
-            return 7;
-        case EIGHT:
-            return 8;
-        case NINE:
-            return 9;
-        case TEN:
-            return 10;
+void process_second(std::string input, GameCommand *command) {
+    if (command->option == OPTION_PLAY or command->option == OPTION_DISCARD) {
+
+        if (input.size() < 2) {
+            throw CaravanInputException("A hand position has not been entered.");
+        }
+
+        char c = input.at(1);
+
+        switch (c) {
+            case '1':
+                command->pos_hand = 1;
+                break;
+            case '2':
+                command->pos_hand = 2;
+                break;
+            case '3':
+                command->pos_hand = 3;
+                break;
+            case '4':
+                command->pos_hand = 4;
+                break;
+            case '5':
+                command->pos_hand = 5;
+                break;
+            case '6':
+                command->pos_hand = 6;
+                break;
+            case '7':
+                command->pos_hand = 7;
+                break;
+            case '8':
+                command->pos_hand = 8;
+                break;
+            default:
+                throw CaravanInputException("Invalid hand position '" + std::string(1, c) + "'.");
+        }
+
+    } else if (command->option == OPTION_CLEAR) {
+
+        if (input.size() < 2) {
+            throw CaravanInputException("A caravan name has not been entered.");
+        }
+
+        char c = input.at(1);
+
+        switch (c) {
+            case 'A':
+            case 'a':
+                command->caravan_name = CARAVAN_A;
+                break;
+            case 'B':
+            case 'b':
+                command->caravan_name = CARAVAN_B;
+                break;
+            case 'C':
+            case 'c':
+                command->caravan_name = CARAVAN_C;
+                break;
+            case 'D':
+            case 'd':
+                command->caravan_name = CARAVAN_D;
+                break;
+            case 'E':
+            case 'e':
+                command->caravan_name = CARAVAN_E;
+                break;
+            case 'F':
+            case 'f':
+                command->caravan_name = CARAVAN_F;
+                break;
+            default:
+                throw CaravanInputException("Invalid caravan name '" + std::string(1, c) + "', must be between: A-F.");
+        }
+
+    } // else invalid command type, handled during parse of first character
+}
+
+void process_third(std::string input, GameCommand *command) {
+    if (command->option == OPTION_PLAY) {
+
+        if (input.size() < 3) {
+            throw CaravanInputException("A caravan name has not been entered.");
+        }
+
+        char c = input.at(2);
+
+        switch (c) {
+            case 'A':
+            case 'a':
+                command->caravan_name = CARAVAN_A;
+                break;
+            case 'B':
+            case 'b':
+                command->caravan_name = CARAVAN_B;
+                break;
+            case 'C':
+            case 'c':
+                command->caravan_name = CARAVAN_C;
+                break;
+            case 'D':
+            case 'd':
+                command->caravan_name = CARAVAN_D;
+                break;
+            case 'E':
+            case 'e':
+                command->caravan_name = CARAVAN_E;
+                break;
+            case 'F':
+            case 'f':
+                command->caravan_name = CARAVAN_F;
+                break;
+            default:
+                throw CaravanInputException("Invalid caravan name '" + std::string(1, c) + "', must be between: A-F.");
+        }
+    }
+}
+
+void process_fourth(std::string input, GameCommand *command) {
+    if (command->option == OPTION_PLAY) {
+
+        if (input.size() < 4) { return; }  // optional, not an error
+
+        char c = input.at(3);
+
+        switch (c) {
+            case '1':
+                command->pos_caravan = 1;
+                break;
+            case '2':
+                command->pos_caravan = 2;
+                break;
+            case '3':
+                command->pos_caravan = 3;
+                break;
+            case '4':
+                command->pos_caravan = 4;
+                break;
+            case '5':
+                command->pos_caravan = 5;
+                break;
+            case '6':
+                command->pos_caravan = 6;
+                break;
+            case '7':
+                command->pos_caravan = 7;
+                break;
+            case '8':
+                command->pos_caravan = 8;
+                break;
+            default:
+                throw CaravanInputException("Invalid caravan position '" + std::string(1, c) + "'.");
+        }
+    }
+}
+
+/**
+ * @param input A move as entered by a player, e.g. "P3B2", "D1" or "CA".
+ * @param command The command to populate. On error, it keeps whatever was
+ *        parsed before the invalid character.
+ *
+ * @throws CaravanInputException Move is invalid or incomplete.
+ */
+void parse_command(std::string input, GameCommand *command) {
+    if (input.empty()) { return; }
+
+    /*
+     * FIRST
+     * - COMMAND TYPE
+     */
+    process_first(input, command);
+
+    /*
+     * SECOND
+     * - HAND POSITION or
+     * - CARAVAN NAME
+     */
+    process_second(input, command);
+
+    /*
+     * THIRD
+     * - CARAVAN NAME
+     */
+    process_third(input, command);
+
+    /*
+     * FOURTH
+     * - CARAVAN POSITION (used when selecting Face card only)
+     */
+    process_fourth(input, command);
+}
+
+/**
+ * @param command A command.
+ * @return The command as a player would enter it, which parse_command turns
+ *         back into the same command, or an empty string if it has no option.
+ */
+std::string format_command(GameCommand *command) {
+    switch (command->option) {
+        case OPTION_PLAY:
+            return "P" +
+                   std::to_string(command->pos_hand) +
+                   caravan_letter(command->caravan_name) +
+                   (command->pos_caravan > 0 ?
+                    std::to_string(command->pos_caravan) : "");
+
+        case OPTION_DISCARD:
+            return "D" + std::to_string(command->pos_hand);
+
+        case OPTION_CLEAR:
+            return "C" + caravan_letter(command->caravan_name);
+
         default:
-            throw CaravanFatalException("Card is not a numeral.");
+            return "";
+    }
+}
+
+/*
+ * ZOBRIST KEYS
+ *
+ * Each key is derived on demand from a unique feature index, so no table has
+ * to be generated or shared between threads. A game position's hash is the
+ * XOR of the keys of every card in it and the player to move.
+ */
+
+const uint64_t ZOBRIST_TRACK = 1;
+const uint64_t ZOBRIST_HAND = 2;
+const uint64_t ZOBRIST_DECK = 3;
+const uint64_t ZOBRIST_TURN = 4;
+
+static uint64_t zobrist_key(uint64_t domain, uint64_t a, uint64_t b, uint64_t c, Card card) {
+    // splitmix64 finaliser
+    uint64_t x = (domain << 40) | (a << 32) | (b << 24) | (c << 16) |
+                 (card.suit << 8) | card.rank;
+
+    x += 0x9E3779B97F4A7C15;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+
+    return x ^ (x >> 31);
+}
+
+/**
+ * @param cvname The caravan.
+ * @param index The index of the slot in the track.
+ * @param layer 0 for the slot's numeral card, or 1-3 for its face cards.
+ * @param c The card.
+ * @return The key for the card at that place on the table.
+ */
+uint64_t zobrist_track(CaravanName cvname, uint8_t index, uint8_t layer, Card c) {
+    return zobrist_key(ZOBRIST_TRACK, cvname, index, layer, c);
+}
+
+uint64_t zobrist_hand(PlayerName pname, uint8_t index, Card c) {
+    return zobrist_key(ZOBRIST_HAND, pname, index, 0, c);
+}
+
+uint64_t zobrist_deck(PlayerName pname, uint8_t index, Card c) {
+    return zobrist_key(ZOBRIST_DECK, pname, index, 0, c);
+}
+
+uint64_t zobrist_turn(PlayerName pname) {
+    if (pname == NO_PLAYER) {
+        return 0;
     }
-}
\ No newline at end of file
+
+    return zobrist_key(ZOBRIST_TURN, pname, 0, 0, {});
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <random>
+#include "caravan/core/random.h"
+#include "caravan/core/exceptions.h"
+
+Random::Random(uint64_t seed) {
+    // Expand the seed with splitmix64, which never gives an all-zero state
+    for (uint64_t &word: s) {
+        uint64_t x = (seed += 0x9E3779B97F4A7C15);
+
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+        word = x ^ (x >> 31);
+    }
+}
+
+/**
+ * @param bound The exclusive upper bound, must be at least 1.
+ * @return A uniformly distributed number in the range [0, bound).
+ *
+ * @throws CaravanFatalException Bound is 0.
+ */
+uint32_t Random::below(uint32_t bound) {
+    if (bound == 0) {
+        throw CaravanFatalException("A random bound must be at least 1.");
+    }
+
+    // Lemire's multiply-shift, rejecting the few values that would bias it
+    uint64_t m = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(m);
+
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+
+        while (low < threshold) {
+            m = (next() >> 32) * bound;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+
+    return m >> 32;
+}
+
+/**
+ * @return A seed taken from the system's source of randomness.
+ */
+uint64_t Random::seed_from_system() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+/**
+ * @return A generator owned by the calling thread, seeded from the system the
+ *         first time the thread asks for it.
+ */
+Random *Random::for_this_thread() {
+    thread_local Random rng(seed_from_system());
+    return &rng;
+}
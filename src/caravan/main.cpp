@@ -47,7 +47,7 @@ int main(int argc, char *argv[]) {
             (OPTS_VERSION, "Print Caravan version.")
             (OPTS_PVP, "A Player vs Player game.")
             (OPTS_BVB, "A Bot vs Bot game.")
-            (OPTS_BOT, "Which bot to play with (normal, friendly).", cxxopts::value<std::string>()->default_value("normal"))
+            (OPTS_BOT, "Which bot to play with (normal, friendly, montecarlo, ismcts, expectimax, cfr, neural).", cxxopts::value<std::string>()->default_value("normal"))
             (OPTS_DELAY, "Delay before bot makes its move (in seconds).", cxxopts::value<float>()->default_value("1.0"))
             (OPTS_FIRST, "Which player goes first (1 or 2).", cxxopts::value<uint8_t>()->default_value("1"))
             (OPTS_CARDS, "Number of cards for each caravan deck (30-162, inclusive).", cxxopts::value<uint8_t>()->default_value("54"))
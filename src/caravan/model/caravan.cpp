@@ -17,11 +17,17 @@ const std::string EXC_CLOSED = "Caravan is closed.";
 void Caravan::clear() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    if (i_track == 0) {
+    if (cs->i_track == 0) {
         throw CaravanGameException("Cannot clear empty caravan.");
     }
 
-    i_track = 0;
+    cs->i_track = 0;
+    cs->suits_present = 0;
+    cs->ranks_present = 0;
+    cs->bid = 0;
+    cs->direction = ANY;
+    cs->suit = NO_SUIT;
+    cs->hash = 0;
 }
 
 /**
@@ -32,26 +38,7 @@ void Caravan::clear() {
 uint16_t Caravan::get_bid() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    uint16_t bid;
-    uint8_t value;
-    uint8_t value_final;
-
-    bid = 0;
-
-    for (int t = 0; t < i_track; ++t) {
-        value = numeral_rank_to_uint8_t(track[t].card.rank);
-        value_final = value;
-
-        for (int f = 0; f < track[t].i_faces; ++f) {
-            if (track[t].faces[f].rank == KING) {
-                value_final <<= 1;
-            }
-        }
-
-        bid += value_final;
-    }
-
-    return bid;
+    return cs->bid;
 }
 
 /**
@@ -64,12 +51,12 @@ uint16_t Caravan::get_bid() {
 Slot Caravan::get_slot(uint8_t pos) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    if (pos < TRACK_NUMERIC_MIN or pos > i_track) {
+    if (pos < TRACK_NUMERIC_MIN or pos > cs->i_track) {
         throw CaravanGameException(
             "The chosen card position is out of range.");
     }
 
-    return track[pos - 1];
+    return cs->track[pos - 1];
 }
 
 /**
@@ -80,49 +67,7 @@ Slot Caravan::get_slot(uint8_t pos) {
 Direction Caravan::get_direction() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    Direction dir;
-    int t_latest;
-    int t_pen;
-    int f;
-    int num_queens;
-
-    if (i_track < 2) {
-        dir = ANY;
-    } else {
-        t_latest = i_track - 1;
-        t_pen = i_track - 2;
-
-        // The last two Numeric cards must be in the correct direction...
-        if (track[t_latest].card.rank > track[t_pen].card.rank) {
-            dir = ASCENDING;
-        } else {
-            dir = DESCENDING;
-        }
-
-        // ...unless Queens have been played against the latest numeral card.
-        // The number of Queens determine if a change in direction has occurred.
-        if (track[t_latest].i_faces > 0) {
-            f = track[t_latest].i_faces - 1;
-            num_queens = 0;
-
-            for (f; f >= 0; --f) {
-                if (track[t_latest].faces[f].rank == QUEEN) {
-                    num_queens += 1;
-                }
-            }
-
-            // An odd number of Queens on a card means the direction is flipped.
-            if (num_queens > 0 and (num_queens % 2) != 0) {
-                if (dir == ASCENDING) {
-                    dir = DESCENDING;
-                } else {
-                    dir = ASCENDING;
-                }
-            }
-        }
-    }
-
-    return dir;
+    return cs->direction;
 }
 
 /**
@@ -144,7 +89,7 @@ CaravanName Caravan::get_name() {
 uint8_t Caravan::get_size() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    return i_track;
+    return cs->i_track;
 }
 
 /**
@@ -155,31 +100,48 @@ uint8_t Caravan::get_size() {
 Suit Caravan::get_suit() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    Suit last;
-    int t;
-    int f;
+    return cs->suit;
+}
 
-    if (i_track == 0) {
-        return NO_SUIT;
-    }
+/**
+ * @param card A card.
+ * @return True if put_numeral_card would accept the card.
+ *
+ * @throws CaravanFatalException Caravan is closed.
+ */
+bool Caravan::can_put_numeral_card(Card card) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    // The last numeral card is the caravan suit...
-    t = i_track - 1;
-    last = track[t].card.suit;
+    if (!is_numeral_card(card) or cs->i_track == TRACK_NUMERIC_MAX) {
+        return false;
+    }
 
-    // ...unless a QUEEN has been played against it.
-    // The most recent QUEEN placement supersedes all others.
-    if (track[t].i_faces > 0) {
-        f = track[t].i_faces - 1;
-        for (f; f >= 0; --f) {
-            if (track[t].faces[f].rank == QUEEN) {
-                last = track[t].faces[f].suit;
-                break;
-            }
+    if (cs->i_track > 0) {
+        if (card.rank == cs->track[cs->i_track - 1].card.rank) {
+            return false;
         }
+
+        return follows_caravan(card);
     }
 
-    return last;
+    return true;
+}
+
+/**
+ * @param card A card.
+ * @param pos Position of numeral card on which to put the card.
+ * @return True if put_face_card would accept the card at the position.
+ *
+ * @throws CaravanFatalException Caravan is closed.
+ */
+bool Caravan::can_put_face_card(Card card, uint8_t pos) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    if (pos < TRACK_NUMERIC_MIN or pos > cs->i_track or !is_face_card(card)) {
+        return false;
+    }
+
+    return card.rank == JACK or cs->track[pos - 1].i_faces < TRACK_FACE_MAX;
 }
 
 /**
@@ -194,48 +156,38 @@ Suit Caravan::get_suit() {
 void Caravan::put_numeral_card(Card card) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    Direction dir;
-    Suit suit;
-    bool ascends;
-    bool not_same_suit;
-    bool not_same_dir;
-
     if (!is_numeral_card(card)) {
         throw CaravanGameException(
             "The card must be a numeral card.");
     }
 
-    if (i_track == TRACK_NUMERIC_MAX) {
+    if (cs->i_track == TRACK_NUMERIC_MAX) {
         throw CaravanGameException(
             "The caravan is at its maximum numeral card capacity.");
     }
 
-    if (i_track > 0) {
-        if (card.rank == track[i_track - 1].card.rank) {
+    if (cs->i_track > 0) {
+        if (card.rank == cs->track[cs->i_track - 1].card.rank) {
             throw CaravanGameException(
                 "A numeral card must not have same rank as "
                 "the most recent card in the caravan.");
         }
 
-        if (i_track > 1) {
-            dir = get_direction();
-            suit = get_suit();
-            ascends = card.rank > track[i_track - 1].card.rank;
-
-            not_same_suit = card.suit != suit;
-            not_same_dir = (dir == ASCENDING and !ascends) or
-                           (dir == DESCENDING and ascends);
-
-            if (not_same_suit and not_same_dir) {
-                throw CaravanGameException(
-                    "The numeral card must follow the caravan's "
-                    "direction or match the caravan's suit.");
-            }
+        if (!follows_caravan(card)) {
+            throw CaravanGameException(
+                "The numeral card must follow the caravan's "
+                "direction or match the caravan's suit.");
         }
     }
 
-    track[i_track] = {card, {}, 0};
-    i_track += 1;
+    cs->track[cs->i_track] = {card, {}, 0};
+    cs->hash ^= zobrist_track(name, cs->i_track, 0, card);
+    cs->i_track += 1;
+    cs->suits_present |= 1 << card.suit;
+    cs->ranks_present |= 1 << card.rank;
+    cs->bid += card_value(card);
+
+    update_tail();
 }
 
 /**
@@ -261,7 +213,7 @@ Card Caravan::put_face_card(Card card, uint8_t pos) {
     }
 
 
-    if (pos > i_track) {
+    if (pos > cs->i_track) {
         throw CaravanGameException(
             "There is not a numeral card at caravan position " +
             std::to_string(pos) + ".");
@@ -272,18 +224,26 @@ Card Caravan::put_face_card(Card card, uint8_t pos) {
     }
 
     i = pos - 1;
-    c_on = track[i].card;
+    c_on = cs->track[i].card;
 
     if (card.rank == JACK) {
         remove_numeral_card(i);
 
     } else {
-        if (track[i].i_faces == TRACK_FACE_MAX) {
+        if (cs->track[i].i_faces == TRACK_FACE_MAX) {
             throw CaravanGameException("The caravan is at its maximum face card capacity.");
         }
 
-        track[i].faces[track[i].i_faces] = card;
-        track[i].i_faces += 1;
+        // A KING doubles the card's current value, including earlier KINGs
+        if (card.rank == KING) {
+            cs->bid += slot_value(cs->track[i]);
+        }
+
+        cs->track[i].faces[cs->track[i].i_faces] = card;
+        cs->track[i].i_faces += 1;
+        cs->hash ^= zobrist_track(name, i, cs->track[i].i_faces, card);
+
+        update_tail();
     }
 
     return c_on;
@@ -302,27 +262,18 @@ Card Caravan::put_face_card(Card card, uint8_t pos) {
 void Caravan::remove_rank(Rank rank, uint8_t pos_exclude) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    uint8_t i_track_original;
-
-    if (i_track == 0) {
+    if (cs->i_track == 0) {
         return;
     }
 
-    if (pos_exclude > i_track) {
+    if (pos_exclude > cs->i_track) {
         throw CaravanFatalException(
             "The exclude position is out of range.");
     }
 
-    i_track_original = i_track;
-
-    for (int t = i_track_original - 1; t >= 0; --t) {
-        if (pos_exclude > 0 and t == (pos_exclude - 1)) {
-            continue;
-        }
-
-        if (track[t].card.rank == rank) {
-            remove_numeral_card(t);
-        }
+    // Most caravans hold no card of the rank
+    if (cs->ranks_present & (1 << rank)) {
+        remove_present(1 << rank, 0, pos_exclude);
     }
 }
 
@@ -339,27 +290,18 @@ void Caravan::remove_rank(Rank rank, uint8_t pos_exclude) {
 void Caravan::remove_suit(Suit suit, uint8_t pos_exclude) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    uint8_t i_track_original;
-
-    if (i_track == 0) {
+    if (cs->i_track == 0) {
         return;
     }
 
-    if (pos_exclude > i_track) {
+    if (pos_exclude > cs->i_track) {
         throw CaravanFatalException(
             "The exclude position is out of range.");
     }
 
-    i_track_original = i_track;
-
-    for (int t = i_track_original - 1; t >= 0; --t) {
-        if (pos_exclude > 0 and t == (pos_exclude - 1)) {
-            continue;
-        }
-
-        if (track[t].card.suit == suit) {
-            remove_numeral_card(t);
-        }
+    // Most caravans hold no card of the suit
+    if (cs->suits_present & (1 << suit)) {
+        remove_present(0, 1 << suit, pos_exclude);
     }
 }
 
@@ -379,46 +321,214 @@ void Caravan::close() {
  */
 
 /**
- * @param rank A numeral rank.
- * @return An integer equivalent of the numeral, range: 1-10.
- *
- * @throws CaravanFatalException If a non-numeral rank is provided.
- * @throws CaravanFatalException Caravan is closed.
+ * @param card A numeral card to place after the most recent card.
+ * @return True if the card follows the caravan's direction or matches its
+ *         suit, or if the caravan has fewer than two cards.
  */
-uint8_t Caravan::numeral_rank_to_uint8_t(Rank rank) {
-    switch (rank) {
-        case ACE:
-            return 1;
-        case TWO:
-            return 2;
-        case THREE:
-            return 3;
-        case FOUR:
-            return 4;
-        case FIVE:
-            return 5;
-        case SIX:
-            return 6;
-        case SEVEN:
-            return 7;
-        case EIGHT:
-            return 8;
-        case NINE:
-            return 9;
-        case TEN:
-            return 10;
-        default:
-            throw CaravanFatalException("Invalid rank.");
+bool Caravan::follows_caravan(Card card) {
+    Direction dir;
+    bool ascends;
+
+    if (cs->i_track < 2) {
+        return true;
+    }
+
+    if (card.suit == cs->suit) {
+        return true;
     }
+
+    dir = cs->direction;
+    ascends = card.rank > cs->track[cs->i_track - 1].card.rank;
+
+    return !((dir == ASCENDING and !ascends) or
+             (dir == DESCENDING and ascends));
 }
 
 /**
  * @param index The index of the numeral card to remove from the caravan.
  */
 void Caravan::remove_numeral_card(uint8_t index) {
-    for (index; (index + 1) < i_track; ++index) {
-        track[index] = track[index + 1];
+    uint8_t t;
+
+    cs->bid -= slot_value(cs->track[index]);
+
+    // Every slot from the index onwards changes position
+    for (t = index; t < cs->i_track; ++t) {
+        cs->hash ^= hash_slot(t);
+    }
+
+    for (t = index; (t + 1) < cs->i_track; ++t) {
+        cs->track[t] = cs->track[t + 1];
+    }
+
+    cs->i_track -= 1;
+
+    for (t = index; t < cs->i_track; ++t) {
+        cs->hash ^= hash_slot(t);
+    }
+
+    update_present();
+    update_tail();
+}
+
+/**
+ * Remove every numeral card whose rank or suit is in the given bits, in a
+ * single pass that keeps the remaining cards in order.
+ *
+ * @param ranks A bit per rank to remove.
+ * @param suits A bit per suit to remove.
+ * @param pos_exclude The numeral card at the position will be kept. If 0, no
+ *                    card is excluded.
+ */
+void Caravan::remove_present(uint16_t ranks, uint8_t suits, uint8_t pos_exclude) {
+    uint8_t t_keep = 0;
+
+    for (uint8_t t = 0; t < cs->i_track; ++t) {
+        Card card = cs->track[t].card;
+        bool remove =
+            t + 1 != pos_exclude and
+            ((ranks & (1 << card.rank)) or (suits & (1 << card.suit)));
+
+        // Slots before the first removal stay where they are
+        if (!remove and t_keep == t) {
+            t_keep += 1;
+            continue;
+        }
+
+        cs->hash ^= hash_slot(t);
+
+        if (remove) {
+            cs->bid -= slot_value(cs->track[t]);
+            continue;
+        }
+
+        cs->track[t_keep] = cs->track[t];
+        cs->hash ^= hash_slot(t_keep);
+        t_keep += 1;
+    }
+
+    if (t_keep < cs->i_track) {
+        cs->i_track = t_keep;
+        update_present();
+        update_tail();
+    }
+}
+
+/**
+ * @param index The index of a numeral card in the caravan.
+ * @return The Zobrist hash of the numeral card and its face cards at that
+ *         index.
+ */
+uint64_t Caravan::hash_slot(uint8_t index) {
+    Slot *slot = &cs->track[index];
+    uint64_t hash = zobrist_track(name, index, 0, slot->card);
+
+    for (uint8_t f = 0; f < slot->i_faces; ++f) {
+        hash ^= zobrist_track(name, index, f + 1, slot->faces[f]);
+    }
+
+    return hash;
+}
+
+/**
+ * @param slot A slot in the caravan.
+ * @return The numeral card's value, doubled for each KING played on it.
+ */
+uint16_t Caravan::slot_value(Slot slot) {
+    uint16_t value = card_value(slot.card);
+
+    for (int f = 0; f < slot.i_faces; ++f) {
+        if (slot.faces[f].rank == KING) {
+            value <<= 1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * Recount which ranks and suits the caravan's numeral cards have.
+ */
+void Caravan::update_present() {
+    cs->suits_present = 0;
+    cs->ranks_present = 0;
+
+    for (uint8_t t = 0; t < cs->i_track; ++t) {
+        cs->suits_present |= 1 << cs->track[t].card.suit;
+        cs->ranks_present |= 1 << cs->track[t].card.rank;
+    }
+}
+
+/**
+ * Update the caravan's direction and suit, which only depend on the two most
+ * recent numeral cards and the face cards played on the most recent one.
+ */
+void Caravan::update_tail() {
+    Direction dir;
+    Suit last;
+    int t_latest;
+    int t_pen;
+    int f;
+    int num_queens;
+
+    if (cs->i_track < 2) {
+        dir = ANY;
+    } else {
+        t_latest = cs->i_track - 1;
+        t_pen = cs->i_track - 2;
+
+        // The last two Numeric cards must be in the correct direction...
+        if (cs->track[t_latest].card.rank > cs->track[t_pen].card.rank) {
+            dir = ASCENDING;
+        } else {
+            dir = DESCENDING;
+        }
+
+        // ...unless Queens have been played against the latest numeral card.
+        // The number of Queens determine if a change in direction has occurred.
+        if (cs->track[t_latest].i_faces > 0) {
+            f = cs->track[t_latest].i_faces - 1;
+            num_queens = 0;
+
+            for (f; f >= 0; --f) {
+                if (cs->track[t_latest].faces[f].rank == QUEEN) {
+                    num_queens += 1;
+                }
+            }
+
+            // An odd number of Queens on a card means the direction is flipped.
+            if (num_queens > 0 and (num_queens % 2) != 0) {
+                if (dir == ASCENDING) {
+                    dir = DESCENDING;
+                } else {
+                    dir = ASCENDING;
+                }
+            }
+        }
+    }
+
+    cs->direction = dir;
+
+    if (cs->i_track == 0) {
+        cs->suit = NO_SUIT;
+        return;
+    }
+
+    // The last numeral card is the caravan suit...
+    t_latest = cs->i_track - 1;
+    last = cs->track[t_latest].card.suit;
+
+    // ...unless a QUEEN has been played against it.
+    // The most recent QUEEN placement supersedes all others.
+    if (cs->track[t_latest].i_faces > 0) {
+        f = cs->track[t_latest].i_faces - 1;
+        for (f; f >= 0; --f) {
+            if (cs->track[t_latest].faces[f].rank == QUEEN) {
+                last = cs->track[t_latest].faces[f].suit;
+                break;
+            }
+        }
     }
 
-    i_track -= 1;
+    cs->suit = last;
 }
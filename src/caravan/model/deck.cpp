@@ -2,14 +2,14 @@
 // The following code can be redistributed and/or
 // modified under the terms of the GPL-3.0 License.
 
-#include <chrono>
-#include <random>
-#include <vector>
-#include <algorithm>
 #include "caravan/model/deck.h"
 #include "caravan/core/common.h"
 #include "caravan/core/exceptions.h"
 
+const uint8_t DECK_TRADITIONAL_NUMERALS = 40;
+const uint8_t DECK_TRADITIONAL_FACES = 14;
+const uint8_t SPLITS_MAX = 64;  // ways to split the opening hand's numerals
+
 /**
  * @param num_cards The number of cards to have in the caravan deck,
  *        must be between 30 and 162 cards (inclusive).
@@ -21,7 +21,7 @@
  *        1, 2, 3, and so on.
  *        If false, then standard decks are sampled randomly.
  *
- * @return A caravan deck.
+ * @return A caravan deck, shuffled with the calling thread's generator.
  *
  * @throws CaravanFatalException Requested number of cards outside of acceptable range.
  * @throws CaravanFatalException Requested number of sample decks outside of acceptable range.
@@ -32,12 +32,60 @@ Deck *DeckBuilder::build_caravan_deck(
     uint8_t num_sample_decks,
     bool balanced_sample) {
 
-    uint8_t total_sample_cards;
-    Deck sample_decks[3];
-    Deck *d;
-    uint8_t i_next;
-    Card c_next;
-    uint8_t first_hand_num_cards;
+    return build_caravan_deck(
+        num_cards, num_sample_decks, balanced_sample,
+        Random::for_this_thread());
+}
+
+/**
+ * As above, but every random choice is taken from the given generator, so the
+ * same generator state always builds the same deck.
+ *
+ * @param rng The generator to use.
+ */
+Deck *DeckBuilder::build_caravan_deck(
+    uint8_t num_cards,
+    uint8_t num_sample_decks,
+    bool balanced_sample,
+    Random *rng) {
+
+    DeckCards cards;
+
+    build_caravan_deck(
+        &cards, num_cards, num_sample_decks, balanced_sample, rng);
+
+    return new Deck(cards.begin(), cards.begin() + num_cards);
+}
+
+/**
+ * As above, but the deck is written into the first num_cards entries of the
+ * given storage, with the top of the deck last, and nothing is allocated.
+ *
+ * Decks follow the same distribution as drawing cards one at a time from
+ * shuffled sample decks and starting again whenever the opening hand has too
+ * few numerals. Instead of starting again, the opening hand's numerals are
+ * chosen first from their distribution given a valid hand, and every other
+ * card is then drawn from what is left.
+ *
+ * @param deck The storage for the caravan deck.
+ */
+void DeckBuilder::build_caravan_deck(
+    DeckCards *deck,
+    uint8_t num_cards,
+    uint8_t num_sample_decks,
+    bool balanced_sample,
+    Random *rng) {
+
+    SampleDeck sample_decks[SAMPLE_DECKS_MAX];
+    std::array<uint8_t, DECK_CARAVAN_MAX> source;  // sample deck of each card
+    std::array<uint8_t, SAMPLE_DECKS_MAX> remaining;
+    std::array<uint8_t, SAMPLE_DECKS_MAX> hand_drawn;
+    std::array<uint8_t, SAMPLE_DECKS_MAX> hand_numerals;
+    std::array<double, SPLITS_MAX> split_weights;
+    uint8_t num_splits;
+    uint8_t i_hand;
+    double weight_total;
+    double u;
 
     if (num_cards < DECK_CARAVAN_MIN or
         num_cards > DECK_CARAVAN_MAX) {
@@ -53,65 +101,126 @@ Deck *DeckBuilder::build_caravan_deck(
             "1 and 3 standard card decks (inclusive).");
     }
 
-    total_sample_cards = num_sample_decks * DECK_TRADITIONAL_MAX;
-
-    if (total_sample_cards < num_cards) {
+    if (num_sample_decks * DECK_TRADITIONAL_MAX < num_cards) {
         throw CaravanFatalException(
             "There are insufficient cards to sample for the "
             "caravan deck.");
     }
 
-    d = new Deck();
+    // The opening hand is dealt from the top of the deck
+    i_hand = num_cards - HAND_SIZE_MAX_START;
 
     do {
-        d->clear();
-        i_next = 0;
-        first_hand_num_cards = 0;
+        remaining = {};
+        hand_drawn = {};
 
         for (int i = 0; i < num_sample_decks; ++i) {
-            sample_decks[i] = DeckBuilder::build_traditional_deck(true);
+            remaining[i] = DECK_TRADITIONAL_MAX;
         }
 
-        if (balanced_sample) {
-            // Sample decks in a round-robin fashion
-            while (d->size() < num_cards) {
-                c_next = sample_decks[i_next].back();
-                d->push_back(c_next);
-                sample_decks[i_next].pop_back();
+        // Choose which sample deck each card comes from
+        for (uint8_t i = 0; i < num_cards; ++i) {
+            if (balanced_sample) {
+                source[i] = i % num_sample_decks;
 
-                i_next = (i_next + 1) % num_sample_decks;
+            } else {
+                // Sample decks randomly, skipping any that are empty
+                uint8_t num_nonempty = 0;
+                uint8_t r;
 
-                if ((num_cards - d->size()) < HAND_SIZE_MAX_START and
-                    is_numeral_card(c_next)) {
-                    first_hand_num_cards += 1;
+                for (int j = 0; j < num_sample_decks; ++j) {
+                    num_nonempty += remaining[j] > 0 ? 1 : 0;
                 }
-            }
 
-        } else {
-            // Sample decks randomly
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> distr(
-                0, num_sample_decks - 1);
-
-            while (d->size() < num_cards) {
-                i_next = distr(gen);
-                if (!sample_decks[i_next].empty()) {
-                    c_next = sample_decks[i_next].back();
-                    d->push_back(c_next);
-                    sample_decks[i_next].pop_back();
-
-                    if ((num_cards - d->size()) < HAND_SIZE_MAX_START and
-                        is_numeral_card(c_next)) {
-                        first_hand_num_cards += 1;
+                r = rng->below(num_nonempty);
+
+                for (int j = 0; j < num_sample_decks; ++j) {
+                    if (remaining[j] > 0) {
+                        if (r == 0) {
+                            source[i] = j;
+                            break;
+                        }
+
+                        r -= 1;
                     }
                 }
             }
+
+            remaining[source[i]] -= 1;
+
+            if (i >= i_hand) {
+                hand_drawn[source[i]] += 1;
+            }
+        }
+
+        // Weigh every split of the opening hand's numerals across the sample
+        // decks that makes a valid hand
+        num_splits = (hand_drawn[0] + 1) * (hand_drawn[1] + 1) * (hand_drawn[2] + 1);
+        weight_total = 0;
+
+        for (uint8_t s = 0; s < num_splits; ++s) {
+            uint8_t k0 = s % (hand_drawn[0] + 1);
+            uint8_t k1 = (s / (hand_drawn[0] + 1)) % (hand_drawn[1] + 1);
+            uint8_t k2 = s / ((hand_drawn[0] + 1) * (hand_drawn[1] + 1));
+
+            split_weights[s] = 0;
+
+            if (k0 + k1 + k2 >= MOVES_START_ROUND) {
+                split_weights[s] =
+                    prob_numerals(hand_drawn[0], k0) *
+                    prob_numerals(hand_drawn[1], k1) *
+                    prob_numerals(hand_drawn[2], k2);
+            }
+
+            weight_total += split_weights[s];
+        }
+
+        // A hand's chance of being valid depends slightly on how it is split
+        // across sample decks, so a random split is kept with that chance.
+        // This only redraws the sources, never any cards.
+    } while (!balanced_sample and num_sample_decks > 1 and
+             rng->unit() >= weight_total);
+
+    // Choose how many of the opening hand's cards from each sample deck are
+    // numerals
+    u = rng->unit() * weight_total;
+
+    for (uint8_t s = 0; s < num_splits; ++s) {
+        if (split_weights[s] > 0) {
+            hand_numerals[0] = s % (hand_drawn[0] + 1);
+            hand_numerals[1] = (s / (hand_drawn[0] + 1)) % (hand_drawn[1] + 1);
+            hand_numerals[2] = s / ((hand_drawn[0] + 1) * (hand_drawn[1] + 1));
+
+            if (u < split_weights[s]) {
+                break;
+            }
+
+            u -= split_weights[s];
+        }
+    }
+
+    for (int j = 0; j < num_sample_decks; ++j) {
+        fill_sample_deck(&sample_decks[j]);
+    }
+
+    // Deal the opening hand, spreading each sample deck's numerals uniformly
+    // across its positions in the hand
+    for (uint8_t i = i_hand; i < num_cards; ++i) {
+        uint8_t j = source[i];
+
+        if (rng->below(hand_drawn[j]) < hand_numerals[j]) {
+            (*deck)[i] = draw_numeral(&sample_decks[j], rng);
+            hand_numerals[j] -= 1;
+        } else {
+            (*deck)[i] = draw_face(&sample_decks[j], rng);
         }
 
-    } while (first_hand_num_cards < MOVES_START_ROUND);
+        hand_drawn[j] -= 1;
+    }
 
-    return d;
+    for (uint8_t i = 0; i < i_hand; ++i) {
+        (*deck)[i] = draw_any(&sample_decks[source[i]], rng);
+    }
 }
 
 /*
@@ -119,37 +228,101 @@ Deck *DeckBuilder::build_caravan_deck(
  */
 
 /**
- * @param shuffle If true, deck is shuffled. If false, it is in numeral order.
- * @return A traditional deck: standard 52 cards + 2 JOKERs.
+ * @param sd The sample deck to fill with a traditional deck: standard 52
+ *        cards + 2 JOKERs.
  */
-Deck DeckBuilder::build_traditional_deck(bool shuffle) {
-    Deck d;
+void DeckBuilder::fill_sample_deck(SampleDeck *sd) {
+    uint8_t i_numeral = 0;
+    uint8_t i_face = DECK_TRADITIONAL_NUMERALS;
 
     for (int i = CLUBS; i <= SPADES; ++i) {
         for (int j = ACE; j <= KING; ++j) {
-            d.push_back({
-                            static_cast<Suit>(i),
-                            static_cast<Rank>(j)
-                        });
+            Card c = {static_cast<Suit>(i), static_cast<Rank>(j)};
+
+            if (is_numeral_card(c)) {
+                sd->cards[i_numeral++] = c;
+            } else {
+                sd->cards[i_face++] = c;
+            }
         }
     }
 
-    d.push_back({NO_SUIT, JOKER});
-    d.push_back({NO_SUIT, JOKER});
+    sd->cards[i_face++] = {NO_SUIT, JOKER};
+    sd->cards[i_face++] = {NO_SUIT, JOKER};
+
+    sd->num_numerals = DECK_TRADITIONAL_NUMERALS;
+    sd->num_faces = DECK_TRADITIONAL_FACES;
+}
+
+/**
+ * @param sd A sample deck with at least one numeral card left.
+ * @param rng The generator to use.
+ * @return A numeral card, removed uniformly at random from the sample deck.
+ */
+Card DeckBuilder::draw_numeral(SampleDeck *sd, Random *rng) {
+    uint8_t i = rng->below(sd->num_numerals);
+    Card c = sd->cards[i];
 
-    if (shuffle) {
-        return shuffle_deck(d);
+    // Fill the gap with the last numeral, then that gap with the last face
+    sd->cards[i] = sd->cards[sd->num_numerals - 1];
+    sd->cards[sd->num_numerals - 1] = sd->cards[sd->num_numerals + sd->num_faces - 1];
+    sd->num_numerals -= 1;
+
+    return c;
+}
+
+/**
+ * @param sd A sample deck with at least one face card left.
+ * @param rng The generator to use.
+ * @return A face card, removed uniformly at random from the sample deck.
+ */
+Card DeckBuilder::draw_face(SampleDeck *sd, Random *rng) {
+    uint8_t i = sd->num_numerals + rng->below(sd->num_faces);
+    Card c = sd->cards[i];
+
+    sd->cards[i] = sd->cards[sd->num_numerals + sd->num_faces - 1];
+    sd->num_faces -= 1;
+
+    return c;
+}
+
+/**
+ * @param sd A sample deck with at least one card left.
+ * @param rng The generator to use.
+ * @return A card, removed uniformly at random from the sample deck.
+ */
+Card DeckBuilder::draw_any(SampleDeck *sd, Random *rng) {
+    if (rng->below(sd->num_numerals + sd->num_faces) < sd->num_numerals) {
+        return draw_numeral(sd, rng);
     } else {
-        return d;
+        return draw_face(sd, rng);
     }
 }
 
 /**
- * @param d The deck to shuffle.
- * @return A deck with shuffled cards.
+ * @param num_drawn Number of cards drawn from a full traditional deck.
+ * @param num_numerals Number of those cards that are numerals.
+ * @return The chance of drawing exactly that many numerals.
  */
-Deck DeckBuilder::shuffle_deck(Deck d) {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::shuffle(d.begin(), d.end(), std::default_random_engine(seed));
-    return d;
-}
\ No newline at end of file
+double DeckBuilder::prob_numerals(uint8_t num_drawn, uint8_t num_numerals) {
+    // Hypergeometric, built up one draw at a time to stay within a double
+    double p = 1;
+    uint8_t numerals_left = DECK_TRADITIONAL_NUMERALS;
+    uint8_t faces_left = DECK_TRADITIONAL_FACES;
+    uint8_t cards_left = DECK_TRADITIONAL_MAX;
+
+    for (uint8_t i = 0; i < num_drawn; ++i) {
+        if (i < num_numerals) {
+            p *= (double) numerals_left-- / cards_left--;
+        } else {
+            p *= (double) faces_left-- / cards_left--;
+        }
+    }
+
+    // Any order of the numerals among the draws is equally likely
+    for (uint8_t i = 0; i < num_numerals; ++i) {
+        p *= (double) (num_drawn - i) / (i + 1);
+    }
+
+    return p;
+}
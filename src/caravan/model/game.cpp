@@ -2,6 +2,7 @@
 // The following code can be redistributed and/or
 // modified under the terms of the GPL-3.0 License.
 
+#include <utility>
 #include "caravan/model/game.h"
 #include "caravan/core/common.h"
 
@@ -17,22 +18,122 @@ Game::Game(GameConfig *gc) {
         throw CaravanFatalException("Invalid player name for first player in game configuration.");
     }
 
-    Deck *deck_top = DeckBuilder::build_caravan_deck(
+    Random rng_seeded(gc->seed);
+    Random *rng = gc->seed != 0 ? &rng_seeded : Random::for_this_thread();
+
+    state = {};
+
+    DeckBuilder::build_caravan_deck(
+        &state.pb.deck,
         gc->player_abc_cards,
         gc->player_abc_samples,
-        gc->player_abc_balanced);
+        gc->player_abc_balanced,
+        rng);
 
-    Deck *deck_bottom = DeckBuilder::build_caravan_deck(
+    DeckBuilder::build_caravan_deck(
+        &state.pa.deck,
         gc->player_def_cards,
         gc->player_def_samples,
-        gc->player_def_balanced);
+        gc->player_def_balanced,
+        rng);
 
-    table_ptr = new Table();
-    pa_ptr = new Player(PLAYER_ABC, deck_bottom);
-    pb_ptr = new Player(PLAYER_DEF, deck_top);
+    table_ptr = new Table(&state.table);
+    pa_ptr = new Player(PLAYER_ABC, &state.pa, gc->player_def_cards);
+    pb_ptr = new Player(PLAYER_DEF, &state.pb, gc->player_abc_cards);
 
     closed = false;
-    p_turn = gc->player_first == pa_ptr->get_name() ? pa_ptr : pb_ptr;
+    state.p_turn = gc->player_first;
+    update_winner(nullptr);
+}
+
+/**
+ * @param gs A game state to copy, such as one taken from another game's clone.
+ *
+ * @throws CaravanFatalException Invalid player turn in game state.
+ */
+Game::Game(GameState *gs) {
+    if (gs->p_turn == NO_PLAYER) {
+        throw CaravanFatalException("Invalid player turn in game state.");
+    }
+
+    state = *gs;
+    table_ptr = new Table(&state.table);
+    pa_ptr = new Player(PLAYER_ABC, &state.pa);
+    pb_ptr = new Player(PLAYER_DEF, &state.pb);
+
+    closed = false;
+    update_winner(nullptr);
+}
+
+/**
+ * @return A copy of the complete game state.
+ */
+GameState Game::clone() {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    return state;
+}
+
+/**
+ * Replace everything the viewer cannot see with a random arrangement that is
+ * consistent with what they can see: the order of the viewer's own deck, and
+ * which of the opponent's remaining cards are in their hand and in what
+ * order their deck is. Hand and deck sizes are unchanged.
+ *
+ * @param viewer The player whose view is kept.
+ * @param rng The generator to use.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
+void Game::determinize(PlayerName viewer, Random *rng) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    PlayerState *ps_me = viewer == PLAYER_ABC ? &state.pa : &state.pb;
+    PlayerState *ps_opp = viewer == PLAYER_ABC ? &state.pb : &state.pa;
+    PlayerName opp = viewer == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+    uint8_t num_opp = ps_opp->i_hand + ps_opp->i_deck;
+
+    for (uint8_t i = ps_me->i_deck; i > 1; --i) {
+        std::swap(ps_me->deck[i - 1], ps_me->deck[rng->below(i)]);
+    }
+
+    // Shuffle the opponent's hand and deck as one pile of unseen cards
+    for (uint8_t i = num_opp; i > 1; --i) {
+        uint8_t j = rng->below(i);
+        Card *c_i = i - 1 < ps_opp->i_hand ? &ps_opp->hand[i - 1] : &ps_opp->deck[i - 1 - ps_opp->i_hand];
+        Card *c_j = j < ps_opp->i_hand ? &ps_opp->hand[j] : &ps_opp->deck[j - ps_opp->i_hand];
+
+        std::swap(*c_i, *c_j);
+    }
+
+    version += 1;
+
+    // Rehash both players' hands and decks
+    for (PlayerState *ps: {ps_me, ps_opp}) {
+        PlayerName pname = ps == ps_me ? viewer : opp;
+
+        ps->hash = 0;
+
+        for (uint8_t i = 0; i < ps->i_hand; ++i) {
+            ps->hash ^= zobrist_hand(pname, i, ps->hand[i]);
+        }
+
+        for (uint8_t i = 0; i < ps->i_deck; ++i) {
+            ps->hash ^= zobrist_deck(pname, i, ps->deck[i]);
+        }
+    }
+}
+
+/**
+ * @param gs A game state to copy over the current state, such as one taken
+ *        from this or another game's clone.
+ */
+void Game::restore(GameState *gs) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    state = *gs;
+    version += 1;
+    update_winner(nullptr);
 }
 
 void Game::close() {
@@ -77,10 +178,41 @@ PlayerCaravanNames Game::get_player_caravan_names(PlayerName pname) {
     throw CaravanFatalException("Invalid player name.");
 }
 
+/**
+ * @return A Zobrist hash of the position: every card on the table, in the
+ *         hands and left in the decks, and the player to move.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
+uint64_t Game::get_hash() {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    uint64_t hash = state.pa.hash ^ state.pb.hash ^ zobrist_turn(state.p_turn);
+
+    for (int i = 0; i < TABLE_CARAVANS_MAX; ++i) {
+        hash ^= state.table[i].hash;
+    }
+
+    return hash;
+}
+
+/**
+ * @return A counter that changes whenever the game is changed through its
+ *         own methods, such as by playing a move, so that anything derived
+ *         from the game only needs to be rebuilt when it differs.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
+uint64_t Game::get_version() {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    return version;
+}
+
 PlayerName Game::get_player_turn() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    return p_turn->get_name();
+    return state.p_turn;
 }
 
 Table *Game::get_table() {
@@ -89,73 +221,200 @@ Table *Game::get_table() {
     return table_ptr;
 }
 
+/**
+ * @return The winner, or NO_PLAYER if nobody has won yet.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
 PlayerName Game::get_winner() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    uint8_t won_pa = 0;
-    uint8_t won_pb = 0;
-    int8_t comp[3];
+    return winner;
+}
 
-    // Check if all three caravans have been sold...
+bool Game::is_closed() {
+    return closed;
+}
 
-    comp[0] = compare_bids(CARAVAN_A, CARAVAN_D);
-    comp[1] = compare_bids(CARAVAN_B, CARAVAN_E);
-    comp[2] = compare_bids(CARAVAN_C, CARAVAN_F);
+/**
+ * Check a single command for the player to move, without playing it. A
+ * command is legal exactly when legal_moves would list it.
+ *
+ * @param command The command, whose logged cards are ignored.
+ * @return True if play_option would accept the command.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
+bool Game::is_legal(GameCommand *command) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    for (int i = 0; i < 3; ++i) {
-        if (comp[i] < 0) {
-            won_pa += 1;
-        } else if (comp[i] > 0) {
-            won_pb += 1;
-        } else {
-            // All three must be sold for there to be a winner
-            break;
-        }
+    Player *pptr = player(state.p_turn);
+    PlayerCaravanNames pcns = get_player_caravan_names(state.p_turn);
+    uint8_t size_hand = pptr->size_hand();
+    bool in_start_stage = pptr->moves_count() < MOVES_START_ROUND;
+    CaravanName cvname = command->caravan_name;
+    bool own = pcns[0] == cvname or pcns[1] == cvname or pcns[2] == cvname;
+    Card c_hand;
+
+    if (size_hand == 0 or winner != NO_PLAYER) {
+        return false;
     }
 
-    // Winner is whoever won at least 2 out of the 3 bids
-    if(won_pa + won_pb == 3) {
-        if (won_pa >= 2) {
-            return pa_ptr->get_name();
+    switch (command->option) {
+        case OPTION_PLAY:
+            if (command->pos_hand < HAND_POS_MIN or command->pos_hand > size_hand or
+                cvname < CARAVAN_A or cvname > CARAVAN_F) {
+                return false;
+            }
 
-        } else if (won_pb >= 2) {
-            return pb_ptr->get_name();
-        }
+            c_hand = pptr->hand()[command->pos_hand - 1];
+
+            if (is_numeral_card(c_hand)) {
+                return own and
+                       !(in_start_stage and table_ptr->caravan(cvname)->size() > 0) and
+                       table_ptr->caravan(cvname)->can_put_numeral_card(c_hand);
+            }
+
+            return !in_start_stage and
+                   table_ptr->can_play_face_card(cvname, c_hand, command->pos_caravan);
+
+        case OPTION_DISCARD:
+            return !in_start_stage and
+                   command->pos_hand >= HAND_POS_MIN and command->pos_hand <= size_hand;
+
+        case OPTION_CLEAR:
+            return !in_start_stage and own and
+                   table_ptr->caravan(cvname)->size() > 0;
+
+        default:
+            return false;
     }
+}
 
-    // Neither player has outbid the other
+/**
+ * Find every move that play_option would accept from a player, as if it were
+ * their turn. No exceptions are thrown for illegal moves; they are skipped.
+ *
+ * @param pname The player to move.
+ * @param moves The list to fill with legal moves, which is cleared first.
+ *
+ * @throws CaravanFatalException Invalid player name.
+ * @throws CaravanFatalException Game is closed.
+ */
+void Game::legal_moves(PlayerName pname, GameCommandList *moves) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    // Check if players have empty hands...
+    Player *pptr = get_player(pname);
+    PlayerCaravanNames pcns = get_player_caravan_names(pname);
+    uint8_t size_hand = pptr->size_hand();
+    bool in_start_stage = pptr->moves_count() < MOVES_START_ROUND;
+    const Hand &hand = pptr->hand();
 
-    if (pa_ptr->get_size_hand() > 0 and pb_ptr->get_size_hand() == 0) {
-        return pa_ptr->get_name();
+    moves->size = 0;
 
-    } else if (pa_ptr->get_size_hand() == 0 and pb_ptr->get_size_hand() > 0) {
-        return pb_ptr->get_name();
+    if (size_hand == 0 or winner != NO_PLAYER) {
+        return;
     }
 
-    // Neither player has an empty hand
+    for (uint8_t pos_hand = 1; pos_hand <= size_hand; ++pos_hand) {
+        Card c_hand = hand[pos_hand - 1];
 
-    // Nobody has won yet...
+        if (is_numeral_card(c_hand)) {
+            for (CaravanName cvname: pcns) {
+                Caravan *cvn = table_ptr->caravan(cvname);
 
-    return NO_PLAYER;
-}
+                if (in_start_stage and cvn->size() > 0) {
+                    continue;
+                }
 
-bool Game::is_closed() {
-    return closed;
+                if (cvn->can_put_numeral_card(c_hand) and
+                    moves->size < MOVES_LEGAL_MAX) {
+                    moves->commands[moves->size] =
+                        {OPTION_PLAY, pos_hand, cvname, 0, c_hand, {}};
+                    moves->size += 1;
+                }
+            }
+
+        } else if (!in_start_stage) {  // is a face card
+            for (int i = CARAVAN_A; i <= CARAVAN_F; ++i) {
+                CaravanName cvname = static_cast<CaravanName>(i);
+                Caravan *cvn = table_ptr->caravan(cvname);
+
+                for (uint8_t pos = 1; pos <= cvn->size(); ++pos) {
+                    if (table_ptr->can_play_face_card(cvname, c_hand, pos) and
+                        moves->size < MOVES_LEGAL_MAX) {
+                        moves->commands[moves->size] =
+                            {OPTION_PLAY, pos_hand, cvname, pos, c_hand,
+                             cvn->slot(pos).card};
+                        moves->size += 1;
+                    }
+                }
+            }
+        }
+
+        if (!in_start_stage and moves->size < MOVES_LEGAL_MAX) {
+            moves->commands[moves->size] =
+                {OPTION_DISCARD, pos_hand, NO_CARAVAN, 0, c_hand, {}};
+            moves->size += 1;
+        }
+    }
+
+    if (!in_start_stage) {
+        for (CaravanName cvname: pcns) {
+            if (table_ptr->caravan(cvname)->size() > 0 and
+                moves->size < MOVES_LEGAL_MAX) {
+                moves->commands[moves->size] =
+                    {OPTION_CLEAR, 0, cvname, 0, {}, {}};
+                moves->size += 1;
+            }
+        }
+    }
 }
 
 void Game::play_option(GameCommand *command) {
+    play_option(command, nullptr);
+}
+
+/**
+ * @param command The command to play.
+ * @param undo If not null, records everything the move changes so that it
+ *        can be reverted with unplay.
+ */
+void Game::play_option(GameCommand *command, GameUndo *undo) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    if (get_winner() != NO_PLAYER) {
+    if (winner != NO_PLAYER) {
         throw CaravanFatalException(
             "The game has already been won.");
     }
 
+    Player *p_turn = state.p_turn == PLAYER_ABC ? pa_ptr : pb_ptr;
+    PlayerState *ps_turn = state.p_turn == PLAYER_ABC ? &state.pa : &state.pb;
+    uint8_t size_deck;
+
+    // Bumped first, as a rejected command may already have changed something
+    version += 1;
+
+    if (undo != nullptr) {
+        undo->p_turn = state.p_turn;
+        undo->i_removed = 0;
+
+        for (int i = 0; i < TABLE_CARAVANS_MAX; ++i) {
+            undo->i_track[i] = state.table[i].i_track;
+            undo->bid[i] = state.table[i].bid;
+            undo->direction[i] = state.table[i].direction;
+            undo->suit[i] = state.table[i].suit;
+            undo->suits_present[i] = state.table[i].suits_present;
+            undo->ranks_present[i] = state.table[i].ranks_present;
+            undo->hash[i] = state.table[i].hash;
+        }
+
+        undo->hash_player = ps_turn->hash;
+    }
+
     switch (command->option) {
         case OPTION_PLAY:
-            option_play(p_turn, command);
+            option_play(p_turn, command, undo);
             break;
 
         case OPTION_DISCARD:
@@ -182,14 +441,103 @@ void Game::play_option(GameCommand *command) {
             throw CaravanFatalException("Invalid play option.");
     }
 
+    if (undo != nullptr and ps_turn->i_hand < HAND_SIZE_MAX_START) {
+        undo->hand_overwritten = ps_turn->hand[ps_turn->i_hand];
+    }
+
+    size_deck = p_turn->get_size_deck();
     p_turn->increment_moves();
     p_turn->maybe_add_card_to_hand();
 
-    if (pa_ptr->get_name() == p_turn->get_name()) {
-        p_turn = pb_ptr;
-    } else {
-        p_turn = pa_ptr;
+    if (undo != nullptr) {
+        undo->drew = p_turn->get_size_deck() < size_deck;
+        undo->command = *command;
+    }
+
+    state.p_turn = state.p_turn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+    update_winner(command);
+}
+
+/**
+ * Revert the most recent move, restoring the game state exactly as it was
+ * before the move. Moves must be reverted in the reverse order they were
+ * played.
+ *
+ * @param undo The record filled when the move was played.
+ *
+ * @throws CaravanFatalException Game is closed.
+ */
+void Game::unplay(GameUndo *undo) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    GameCommand *command = &undo->command;
+    PlayerState *ps = undo->p_turn == PLAYER_ABC ? &state.pa : &state.pb;
+
+    // Return the drawn card to the top of the deck
+    if (undo->drew) {
+        ps->i_hand -= 1;
+        ps->i_deck += 1;
+    }
+
+    if (ps->i_hand < HAND_SIZE_MAX_START) {
+        ps->hand[ps->i_hand] = undo->hand_overwritten;
+    }
+
+    ps->moves -= 1;
+
+    // Return the played or discarded card to its position in the hand
+    if (command->option == OPTION_PLAY or command->option == OPTION_DISCARD) {
+        for (uint8_t i = ps->i_hand; i >= command->pos_hand; --i) {
+            ps->hand[i] = ps->hand[i - 1];
+        }
+
+        ps->hand[command->pos_hand - 1] = command->hand;
+        ps->i_hand += 1;
+    }
+
+    if (command->option == OPTION_PLAY) {
+        CaravanState *cs = &state.table[command->caravan_name - 1];
+
+        if (is_numeral_card(command->hand)) {
+            cs->i_track -= 1;
+            cs->track[cs->i_track] = undo->slot_overwritten;
+
+        } else {
+            // Reinserting in ascending order puts every slot back in place
+            for (uint8_t r = 0; r < undo->i_removed; ++r) {
+                RemovedSlot *rs = &undo->removed[r];
+                CaravanState *cs_removed = &state.table[rs->caravan_name - 1];
+
+                for (uint8_t t = cs_removed->i_track; t >= rs->pos; --t) {
+                    cs_removed->track[t] = cs_removed->track[t - 1];
+                }
+
+                cs_removed->track[rs->pos - 1] = rs->slot;
+                cs_removed->i_track += 1;
+            }
+
+            if (command->hand.rank != JACK) {
+                Slot *slot = &cs->track[command->pos_caravan - 1];
+                slot->i_faces -= 1;
+                slot->faces[slot->i_faces] = undo->face_overwritten;
+            }
+        }
     }
+
+    for (int i = 0; i < TABLE_CARAVANS_MAX; ++i) {
+        state.table[i].i_track = undo->i_track[i];
+        state.table[i].bid = undo->bid[i];
+        state.table[i].direction = undo->direction[i];
+        state.table[i].suit = undo->suit[i];
+        state.table[i].suits_present = undo->suits_present[i];
+        state.table[i].ranks_present = undo->ranks_present[i];
+        state.table[i].hash = undo->hash[i];
+    }
+
+    ps->hash = undo->hash_player;
+    state.p_turn = undo->p_turn;
+    version += 1;
+    update_winner(&undo->command);
 }
 
 bool Game::is_caravan_winning(CaravanName cvname) {
@@ -208,7 +556,7 @@ bool Game::is_caravan_bust(CaravanName cvname) {
     if (cvname == NO_CARAVAN) {
         return false;
     } else {
-        return table_ptr->get_caravan(cvname)->get_bid() > CARAVAN_SOLD_MAX;
+        return table_ptr->get_caravan(cvname)->bid() > CARAVAN_SOLD_MAX;
     }
 }
 
@@ -241,8 +589,8 @@ int8_t Game::compare_bids(CaravanName cvname1, CaravanName cvname2) {
 
     if (has_sold(cvname1)) {
         if (has_sold(cvname2)) {
-            bid_cn1 = table_ptr->get_caravan(cvname1)->get_bid();
-            bid_cn2 = table_ptr->get_caravan(cvname2)->get_bid();
+            bid_cn1 = table_ptr->caravan(cvname1)->bid();
+            bid_cn2 = table_ptr->caravan(cvname2)->bid();
 
             if (bid_cn1 > bid_cn2) {
                 return -1;  // CN1 sold; CN2 sold; CN1 highest bid
@@ -264,6 +612,86 @@ int8_t Game::compare_bids(CaravanName cvname1, CaravanName cvname2) {
     }  // CN1 unsold; CN2 unsold
 }
 
+/**
+ * @return The winner from the last compared bids and the current hand sizes.
+ */
+PlayerName Game::find_winner() {
+    uint8_t won_pa = 0;
+    uint8_t won_pb = 0;
+
+    // Check if all three caravans have been sold...
+
+    for (int i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
+        if (bids_compared[i] < 0) {
+            won_pa += 1;
+        } else if (bids_compared[i] > 0) {
+            won_pb += 1;
+        } else {
+            // All three must be sold for there to be a winner
+            break;
+        }
+    }
+
+    // Winner is whoever won at least 2 out of the 3 bids
+    if(won_pa + won_pb == 3) {
+        if (won_pa >= 2) {
+            return PLAYER_ABC;
+
+        } else if (won_pb >= 2) {
+            return PLAYER_DEF;
+        }
+    }
+
+    // Neither player has outbid the other
+
+    // Check if players have empty hands...
+
+    if (pa_ptr->size_hand() > 0 and pb_ptr->size_hand() == 0) {
+        return PLAYER_ABC;
+
+    } else if (pa_ptr->size_hand() == 0 and pb_ptr->size_hand() > 0) {
+        return PLAYER_DEF;
+    }
+
+    // Neither player has an empty hand
+
+    // Nobody has won yet...
+
+    return NO_PLAYER;
+}
+
+/**
+ * @param i_pair The pair of opposite caravans to compare, from 0 (A and D).
+ */
+void Game::update_bids(uint8_t i_pair) {
+    bids_compared[i_pair] = compare_bids(
+        static_cast<CaravanName>(CARAVAN_A + i_pair),
+        static_cast<CaravanName>(CARAVAN_D + i_pair));
+}
+
+/**
+ * Work out the winner again, comparing only the bids that a command could
+ * have changed: those of its caravan's pair, or every pair for a JOKER.
+ * Every move changes a hand, so the hand sizes are always checked.
+ *
+ * @param command The command just played or unplayed, or nullptr to compare
+ *        every pair.
+ */
+void Game::update_winner(GameCommand *command) {
+    if (command == nullptr or
+        (command->option == OPTION_PLAY and command->hand.rank == JOKER)) {
+
+        for (uint8_t i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
+            update_bids(i);
+        }
+
+    } else if (command->option != OPTION_DISCARD) {
+        update_bids((command->caravan_name - CARAVAN_A) % PLAYER_CARAVANS_MAX);
+    }
+
+    winner = find_winner();
+}
+
 CaravanName Game::winning_bid(CaravanName cvname1, CaravanName cvname2) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
@@ -279,7 +707,7 @@ CaravanName Game::winning_bid(CaravanName cvname1, CaravanName cvname2) {
 }
 
 bool Game::has_sold(CaravanName cvname) {
-    uint8_t bid = table_ptr->get_caravan(cvname)->get_bid();
+    uint8_t bid = table_ptr->caravan(cvname)->bid();
     return bid >= CARAVAN_SOLD_MIN and bid <= CARAVAN_SOLD_MAX;
 }
 
@@ -303,7 +731,7 @@ void Game::option_discard(Player *pptr, GameCommand *command) {
     command->hand = c_hand;  // Log to command
 }
 
-void Game::option_play(Player *pptr, GameCommand *command) {
+void Game::option_play(Player *pptr, GameCommand *command, GameUndo *undo) {
     Card c_hand = pptr->get_from_hand_at(command->pos_hand);
 
     command->hand = c_hand;  // Log to command
@@ -339,6 +767,14 @@ void Game::option_play(Player *pptr, GameCommand *command) {
                 "during the Start round.");
         }
 
+        if (undo != nullptr) {
+            CaravanState *cs = &state.table[command->caravan_name - 1];
+
+            if (cs->i_track < TRACK_NUMERIC_MAX) {
+                undo->slot_overwritten = cs->track[cs->i_track];
+            }
+        }
+
         table_ptr->play_numeral_card(command->caravan_name, c_hand);
 
     } else {  // is a face card
@@ -350,6 +786,11 @@ void Game::option_play(Player *pptr, GameCommand *command) {
 
         // Log to command
         command->board = table_ptr->get_caravan(command->caravan_name)->get_slot(command->pos_caravan).card;
+
+        if (undo != nullptr) {
+            record_removed(undo, command, c_hand);
+        }
+
         table_ptr->play_face_card(
             command->caravan_name,
             c_hand,
@@ -358,3 +799,53 @@ void Game::option_play(Player *pptr, GameCommand *command) {
 
     pptr->discard_from_hand_at(command->pos_hand);
 }
+
+/**
+ * Record the slots that a face card will remove from the table, and the face
+ * storage it will overwrite, before the card is played.
+ *
+ * @param undo The record to fill.
+ * @param command A command to play a face card on a valid caravan position.
+ * @param c_hand The face card being played.
+ */
+void Game::record_removed(GameUndo *undo, GameCommand *command, Card c_hand) {
+    uint8_t i_target = command->caravan_name - 1;
+    uint8_t t_target = command->pos_caravan - 1;
+    Slot *target = &state.table[i_target].track[t_target];
+
+    if (target->i_faces < TRACK_FACE_MAX) {
+        undo->face_overwritten = target->faces[target->i_faces];
+    }
+
+    if (c_hand.rank == JACK) {
+        undo->removed[0] = {command->caravan_name, command->pos_caravan, *target};
+        undo->i_removed = 1;
+
+    } else if (c_hand.rank == JOKER) {
+        // Matches the sweep in Table::play_face_card
+        Card c_target = target->card;
+
+        for (uint8_t i = 0; i < TABLE_CARAVANS_MAX; ++i) {
+            CaravanState *cs = &state.table[i];
+            bool present = c_target.rank == ACE ?
+                           cs->suits_present & (1 << c_target.suit) :
+                           cs->ranks_present & (1 << c_target.rank);
+
+            if (!present) { continue; }
+
+            for (uint8_t t = 0; t < cs->i_track; ++t) {
+                bool match = c_target.rank == ACE ?
+                             cs->track[t].card.suit == c_target.suit :
+                             cs->track[t].card.rank == c_target.rank;
+
+                if (match and !(i == i_target and t == t_target)) {
+                    undo->removed[undo->i_removed] = {
+                        static_cast<CaravanName>(i + 1),
+                        static_cast<uint8_t>(t + 1),
+                        cs->track[t]};
+                    undo->i_removed += 1;
+                }
+            }
+        }
+    }
+}
@@ -2,55 +2,113 @@
 // The following code can be redistributed and/or
 // modified under the terms of the GPL-3.0 License.
 
+#include <utility>
 #include "caravan/model/player.h"
 #include "caravan/core/exceptions.h"
 
 const std::string EXC_CLOSED = "Player is closed.";
 
-Player::Player(PlayerName pn, Deck *d) {
+/**
+ * A player whose state is held externally, such as in a game state. The
+ * state is reset and the opening hand is taken from the deck.
+ *
+ * @param pn The player name.
+ * @param state The player state.
+ * @param d The player's deck, which is moved into the state and deleted.
+ */
+Player::Player(PlayerName pn, PlayerState *state, Deck *d) : Player(pn, state) {
+    *ps = {};
+
+    for (Card c: *d) {
+        ps->deck[ps->i_deck] = c;
+        ps->i_deck += 1;
+    }
+
+    delete d;
+
+    deal();
+}
+
+/**
+ * A player whose deck has already been built into an external state, such as
+ * by DeckBuilder. The rest of the state is reset and the opening hand is
+ * taken from the deck.
+ *
+ * @param pn The player name.
+ * @param state The player state.
+ * @param size_deck The number of cards in the state's deck.
+ */
+Player::Player(PlayerName pn, PlayerState *state, uint8_t size_deck) : Player(pn, state) {
+    ps->hand = {};
+    ps->i_hand = 0;
+    ps->i_deck = size_deck;
+    ps->moves = 0;
+
+    deal();
+}
+
+/**
+ * A player whose existing state is held externally, such as in a game state.
+ *
+ * @param pn The player name.
+ * @param state The player state.
+ */
+Player::Player(PlayerName pn, PlayerState *state) {
     name = pn;
-    deck = d;
-    hand = {};
-    i_hand = 0;
-    moves = 0;
+    ps = state;
     closed = false;
-
-    for (; i_hand < HAND_SIZE_MAX_START; i_hand++) {
-        hand[i_hand] = deck->back();
-        deck->pop_back();
-    }
 }
 
 void Player::close() {
     if (!closed) {
-        delete deck;
-
         closed = true;
     }
 }
 
+/**
+ * @param pos The deck position, from 1 at the bottom to the deck size at the
+ *        top.
+ * @return The card at the position.
+ *
+ * @throws CaravanFatalException Deck is empty.
+ * @throws CaravanFatalException Position is out of range.
+ */
+Card Player::get_from_deck_at(uint8_t pos) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    if (ps->i_deck == 0) {
+        throw CaravanFatalException("Player's deck is empty.");
+    }
+
+    if (pos < 1 or pos > ps->i_deck) {
+        throw CaravanFatalException("The chosen deck position is out of range.");
+    }
+
+    return ps->deck[pos - 1];
+}
+
 Card Player::get_from_hand_at(uint8_t pos) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
 
-    if (i_hand == 0) {
+    if (ps->i_hand == 0) {
         throw CaravanFatalException("Player's hand is empty.");
     }
 
-    if (pos < HAND_POS_MIN or pos > i_hand) {
+    if (pos < HAND_POS_MIN or pos > ps->i_hand) {
         throw CaravanGameException("The chosen hand position is out of range.");
     }
 
-    return hand[pos - 1];
+    return ps->hand[pos - 1];
 }
 
 Hand Player::get_hand() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    return hand;
+    return ps->hand;
 }
 
 uint16_t Player::get_moves_count() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    return moves;
+    return ps->moves;
 }
 
 PlayerName Player::get_name() {
@@ -60,29 +118,27 @@ PlayerName Player::get_name() {
 
 uint8_t Player::get_size_deck() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    return deck->size();
+    return ps->i_deck;
 }
 
 uint8_t Player::get_size_hand() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    return i_hand;
+    return ps->i_hand;
 }
 
 void Player::increment_moves() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    moves += 1;
+    ps->moves += 1;
 }
 
 void Player::maybe_add_card_to_hand() {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
     // If more cards in the deck
-    if (!deck->empty()) {
+    if (ps->i_deck > 0) {
         // If post-Start and hand not at post-Start max (5 cards)
-        if (moves > MOVES_START_ROUND and i_hand < HAND_SIZE_MAX_POST_START) {
+        if (ps->moves > MOVES_START_ROUND and ps->i_hand < HAND_SIZE_MAX_POST_START) {
             // Add new card from deck to top of hand
-            hand[i_hand] = deck->back();
-            deck->pop_back();
-            i_hand += 1;
+            draw_card();
         }
     }
 }
@@ -92,25 +148,99 @@ Card Player::discard_from_hand_at(uint8_t pos) {
     uint8_t i;
     Card c_ret;
 
-    if (i_hand == 0) {
+    if (ps->i_hand == 0) {
         throw CaravanFatalException(
             "Player's hand is empty.");
     }
 
-    if (pos < HAND_POS_MIN or pos > i_hand) {
+    if (pos < HAND_POS_MIN or pos > ps->i_hand) {
         throw CaravanGameException(
             "The chosen hand position is out of range.");
     }
 
     i = pos - 1;
-    c_ret = hand[i];
+    c_ret = ps->hand[i];
+
+    // Every card from the position onwards changes position
+    for (i = pos - 1; i < ps->i_hand; ++i) {
+        ps->hash ^= zobrist_hand(name, i, ps->hand[i]);
+    }
 
     // Move the cards above it downwards
-    for (i; (i + 1) < i_hand; ++i) {
-        hand[i] = hand[i + 1];
+    for (i = pos - 1; (i + 1) < ps->i_hand; ++i) {
+        ps->hand[i] = ps->hand[i + 1];
     }
 
-    i_hand -= 1;
+    ps->i_hand -= 1;
+
+    for (i = pos - 1; i < ps->i_hand; ++i) {
+        ps->hash ^= zobrist_hand(name, i, ps->hand[i]);
+    }
 
     return c_ret;
 }
+
+/**
+ * Swap a card in the deck with the top card, so that it is the next card
+ * drawn. Swapping with the same position again undoes the swap.
+ *
+ * @param pos The deck position, as in get_from_deck_at.
+ *
+ * @throws CaravanFatalException Deck is empty.
+ * @throws CaravanFatalException Position is out of range.
+ */
+void Player::swap_with_deck_top(uint8_t pos) {
+    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
+
+    if (ps->i_deck == 0) {
+        throw CaravanFatalException("Player's deck is empty.");
+    }
+
+    if (pos < 1 or pos > ps->i_deck) {
+        throw CaravanFatalException("The chosen deck position is out of range.");
+    }
+
+    uint8_t i = pos - 1;
+    uint8_t top = ps->i_deck - 1;
+
+    ps->hash ^= zobrist_deck(name, i, ps->deck[i]);
+    ps->hash ^= zobrist_deck(name, top, ps->deck[top]);
+
+    std::swap(ps->deck[i], ps->deck[top]);
+
+    ps->hash ^= zobrist_deck(name, i, ps->deck[i]);
+    ps->hash ^= zobrist_deck(name, top, ps->deck[top]);
+}
+
+/*
+ * PROTECTED
+ */
+
+/**
+ * Hash the full deck, then take the opening hand from it.
+ */
+void Player::deal() {
+    ps->hash = 0;
+
+    for (uint8_t i = 0; i < ps->i_deck; ++i) {
+        ps->hash ^= zobrist_deck(name, i, ps->deck[i]);
+    }
+
+    while (ps->i_hand < HAND_SIZE_MAX_START) {
+        draw_card();
+    }
+}
+
+/**
+ * Move the top card of the deck to the top of the hand.
+ */
+void Player::draw_card() {
+    Card c = ps->deck[ps->i_deck - 1];
+
+    ps->i_deck -= 1;
+    ps->hash ^= zobrist_deck(name, ps->i_deck, c);
+
+    ps->hand[ps->i_hand] = c;
+    ps->hash ^= zobrist_hand(name, ps->i_hand, c);
+    ps->i_hand += 1;
+}
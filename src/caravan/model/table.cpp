@@ -8,27 +8,27 @@
 const std::string EXC_CLOSED = "Table is closed.";
 
 /**
- * The table on which caravan tracks are placed, as well as the decks and hands of both players.
+ * The table on which caravan tracks are placed. The tracks are held in state
+ * owned by the caller, such as a game state.
+ *
+ * @param state The state of all caravan tracks on the table.
  */
-Table::Table() {
-    closed = false;
-}
+Table::Table(TableState *state) :
+    caravans{{
+        Caravan(CARAVAN_A, &state->at(0)),
+        Caravan(CARAVAN_B, &state->at(1)),
+        Caravan(CARAVAN_C, &state->at(2)),
+        Caravan(CARAVAN_D, &state->at(3)),
+        Caravan(CARAVAN_E, &state->at(4)),
+        Caravan(CARAVAN_F, &state->at(5))
+    }},
+    closed(false) {}
 
 void Table::close() {
     if (!closed) {
-        a->close();
-        b->close();
-        c->close();
-        d->close();
-        e->close();
-        f->close();
-
-        delete a;
-        delete b;
-        delete c;
-        delete d;
-        delete e;
-        delete f;
+        for (Caravan &cvn: caravans) {
+            cvn.close();
+        }
 
         closed = true;
     }
@@ -43,22 +43,12 @@ void Table::close() {
  */
 Caravan *Table::get_caravan(CaravanName cvname) {
     if (closed) { throw CaravanFatalException(EXC_CLOSED); }
-    switch (cvname) {
-        case CARAVAN_A:
-            return a;
-        case CARAVAN_B:
-            return b;
-        case CARAVAN_C:
-            return c;
-        case CARAVAN_D:
-            return d;
-        case CARAVAN_E:
-            return e;
-        case CARAVAN_F:
-            return f;
-        default:
-            throw CaravanFatalException("Invalid caravan name.");
+
+    if (cvname < CARAVAN_A or cvname > CARAVAN_F) {
+        throw CaravanFatalException("Invalid caravan name.");
     }
+
+    return &caravans[cvname - CARAVAN_A];
 }
 
 /**
@@ -67,10 +57,27 @@ Caravan *Table::get_caravan(CaravanName cvname) {
  * @throws CaravanFatalException Table is closed.
  */
 void Table::clear_caravan(CaravanName cvname) {
-    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
     get_caravan(cvname)->clear();
 }
 
+/**
+ * @param cvname A caravan name.
+ * @param card A card.
+ * @param pos The position of the numeral card on which to place the card.
+ * @return True if play_face_card would accept the card at the position.
+ *
+ * @throws CaravanFatalException Table is closed.
+ */
+bool Table::can_play_face_card(CaravanName cvname, Card card, uint8_t pos) {
+    Caravan *cvn_target = get_caravan(cvname);
+
+    if (card.rank == QUEEN and pos != cvn_target->size()) {
+        return false;
+    }
+
+    return cvn_target->can_put_face_card(card, pos);
+}
+
 /**
  * @param cvname A caravan name.
  * @param card A face card.
@@ -80,10 +87,9 @@ void Table::clear_caravan(CaravanName cvname) {
  * @throws CaravanFatalException Table is closed.
  */
 void Table::play_face_card(CaravanName cvname, Card card, uint8_t pos) {
-    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
     Caravan *cvn_target = get_caravan(cvname);
 
-    if (card.rank == QUEEN and pos != cvn_target->get_size()) {
+    if (card.rank == QUEEN and pos != cvn_target->size()) {
         throw CaravanGameException(
             "A QUEEN can only be played on the latest numeral card in a caravan.");
     }
@@ -102,18 +108,16 @@ void Table::play_face_card(CaravanName cvname, Card card, uint8_t pos) {
         }
 
         // Remove from other caravans, not excluding any cards.
-        for (int k = 0; k < TABLE_CARAVANS_MAX; k++) {
-            Caravan *p_next = caravans[k];
-
+        for (Caravan &cvn_next: caravans) {
             // Ignore original caravan already handled.
-            if (p_next->get_name() == cvn_target->get_name()) {
+            if (&cvn_next == cvn_target) {
                 continue;
             }
 
             if (c_target.rank == ACE) {
-                p_next->remove_suit(c_target.suit, 0);
+                cvn_next.remove_suit(c_target.suit, 0);
             } else {
-                p_next->remove_rank(c_target.rank, 0);
+                cvn_next.remove_rank(c_target.rank, 0);
             }
         }
     }
@@ -126,6 +130,5 @@ void Table::play_face_card(CaravanName cvname, Card card, uint8_t pos) {
  * @throws CaravanFatalException Table is closed.
  */
 void Table::play_numeral_card(CaravanName cvname, Card card) {
-    if (closed) { throw CaravanFatalException(EXC_CLOSED); }
     get_caravan(cvname)->put_numeral_card(card);
 }
@@ -0,0 +1,369 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cxxopts.hpp"
+#include "caravan/model/game.h"
+#include "caravan/user/bot/factory.h"
+#include "caravan/user/bot/shard.h"
+
+const std::string OPTS_HELP = "h,help";
+const std::string OPTS_VERSION = "v,version";
+const std::string OPTS_GAMES = "n,games";
+const std::string OPTS_THREADS = "t,threads";
+const std::string OPTS_BOT_ABC = "bot-abc";
+const std::string OPTS_BOT_DEF = "bot-def";
+const std::string OPTS_FIRST = "f,first";
+const std::string OPTS_CARDS = "c,cards";
+const std::string OPTS_SAMPLES = "s,samples";
+const std::string OPTS_IMBALANCED = "i,imbalanced";
+const std::string OPTS_SEED = "seed";
+const std::string OPTS_OUTPUT = "o,output";
+const std::string OPTS_SHARD_RECORDS = "shard-records";
+
+const std::string KEY_HELP = "help";
+const std::string KEY_VERSION = "version";
+const std::string KEY_GAMES = "games";
+const std::string KEY_THREADS = "threads";
+const std::string KEY_BOT_ABC = "bot-abc";
+const std::string KEY_BOT_DEF = "bot-def";
+const std::string KEY_FIRST = "first";
+const std::string KEY_CARDS = "cards";
+const std::string KEY_SAMPLES = "samples";
+const std::string KEY_IMBALANCED = "imbalanced";
+const std::string KEY_SEED = "seed";
+const std::string KEY_OUTPUT = "output";
+const std::string KEY_SHARD_RECORDS = "shard-records";
+
+const uint8_t FIRST_ABC = 1;
+const uint8_t FIRST_DEF = 2;
+
+typedef struct SimConfig {
+    GameConfig gc;
+    std::string bot_abc;
+    std::string bot_def;
+    uint32_t games{0};
+    uint64_t seed{0};
+    std::string output;  // prefix for self-play shards, or empty
+    uint64_t shard_records{0};
+} SimConfig;
+
+typedef struct SimResult {
+    uint32_t games{0};
+    uint32_t won_abc{0};
+    uint32_t won_def{0};
+    uint64_t moves{0};
+    uint64_t records{0};
+    uint32_t shards{0};
+} SimResult;
+
+typedef struct SimShared {
+    std::atomic<uint32_t> next_game{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    SimResult result;
+    std::string msg_fatal;
+} SimShared;
+
+/**
+ * Closes a game and its bots when it goes out of scope, so that they are
+ * closed however the game ends. The bots are deleted by their owners.
+ */
+typedef struct SimGuard {
+    Game *game;
+    std::unique_ptr<UserBot> *bot_abc;
+    std::unique_ptr<UserBot> *bot_def;
+
+    ~SimGuard() {
+        if (*bot_abc) { (*bot_abc)->close(); }
+        if (*bot_def) { (*bot_def)->close(); }
+        game->close();
+    }
+} SimGuard;
+
+/**
+ * Play a single game between two bots without any view.
+ *
+ * @param sc Simulation configuration.
+ * @param i_game The game's index in the run, which picks its seed.
+ * @param result The result to which the game's outcome is added.
+ * @param writer If not null, every position is written to it along with the
+ *        move played and the game's winner.
+ * @param records Space for the game's records until its winner is known.
+ *
+ * @throws CaravanException Bot made an invalid move or game failed.
+ */
+void play_game(
+    SimConfig *sc, uint32_t i_game, SimResult *result,
+    ShardWriter *writer, std::vector<ShardRecord> *records) {
+    GameConfig gc = sc->gc;
+
+    // Each game has its own seed, so results do not depend on the threads
+    gc.seed = sc->seed == 0 ? 0 : sc->seed + i_game;
+    uint64_t seed_abc = gc.seed == 0 ? 0 : gc.seed * 2 + 1;
+    uint64_t seed_def = gc.seed == 0 ? 0 : gc.seed * 2 + 2;
+    std::unique_ptr<UserBot> bot_abc;
+    std::unique_ptr<UserBot> bot_def;
+    Game game{&gc};
+    SimGuard guard{&game, &bot_abc, &bot_def};
+    PlayerName winner;
+
+    // Bots search on one thread to a fixed budget, so a seeded game replays
+    bot_abc.reset(BotFactory::get(sc->bot_abc, PLAYER_ABC, seed_abc, true));
+    bot_def.reset(BotFactory::get(sc->bot_def, PLAYER_DEF, seed_def, true));
+    records->clear();
+
+    while ((winner = game.get_winner()) == NO_PLAYER) {
+        UserBot *bot_turn = game.get_player_turn() == PLAYER_ABC ?
+                            bot_abc.get() : bot_def.get();
+        GameCommand command;
+
+        if (writer != nullptr) {
+            ShardRecord *record = &records->emplace_back();
+
+            record->player = game.get_player_turn();
+            record->move = records->size() - 1;
+            encode_features(&game, record->player, &record->features);
+        }
+
+        command = bot_turn->request_command(&game);
+        game.play_option(&command);
+
+        if (writer != nullptr) {
+            encode_command(&command, &records->back());
+        }
+    }
+
+    if (writer != nullptr) {
+        for (ShardRecord &record: *records) {
+            record.winner = winner;
+        }
+
+        writer->write(records->data(), records->size());
+    }
+
+    result->games += 1;
+    result->moves +=
+        game.get_player(PLAYER_ABC)->get_moves_count() +
+        game.get_player(PLAYER_DEF)->get_moves_count();
+
+    if (winner == PLAYER_ABC) {
+        result->won_abc += 1;
+    } else {
+        result->won_def += 1;
+    }
+}
+
+/**
+ * Play games until the shared game counter reaches the requested number of
+ * games, then merge this worker's results into the shared results. If
+ * self-play data is requested, each worker writes its own shards.
+ */
+void run_worker(SimConfig *sc, SimShared *shared, uint32_t i_worker) {
+    SimResult result;
+    uint32_t i_game;
+    std::unique_ptr<ShardWriter> writer;
+    std::vector<ShardRecord> records;
+
+    try {
+        if (!sc->output.empty()) {
+            char suffix[16];
+
+            snprintf(suffix, sizeof(suffix), "-t%02u", i_worker);
+            writer = std::make_unique<ShardWriter>(
+                sc->output + suffix, sc->shard_records);
+        }
+
+        while (!shared->failed.load(std::memory_order_relaxed) &&
+               (i_game = shared->next_game.fetch_add(1)) < sc->games) {
+            play_game(sc, i_game, &result, writer.get(), &records);
+        }
+
+        if (writer != nullptr) {
+            result.records = writer->get_records();
+            result.shards = writer->get_shards();
+            writer->close();
+        }
+
+    } catch (CaravanException &e) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->failed = true;
+        shared->msg_fatal = e.what();
+
+    } catch (std::exception &e) {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->failed = true;
+        shared->msg_fatal = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    shared->result.games += result.games;
+    shared->result.won_abc += result.won_abc;
+    shared->result.won_def += result.won_def;
+    shared->result.moves += result.moves;
+    shared->result.records += result.records;
+    shared->result.shards += result.shards;
+}
+
+int main(int argc, char *argv[]) {
+    SimConfig sc;
+    SimShared shared;
+    uint32_t threads;
+
+    try {
+        cxxopts::Options options(std::string(CARAVAN_NAME) + "-sim");
+
+        options.add_options()
+            (OPTS_HELP, "Print help instructions.")
+            (OPTS_VERSION, "Print Caravan version.")
+            (OPTS_GAMES, "Number of games to play.", cxxopts::value<uint32_t>()->default_value("1000"))
+            (OPTS_THREADS, "Number of worker threads (0 uses all cores).", cxxopts::value<uint32_t>()->default_value("0"))
+            (OPTS_BOT_ABC, "Which bot plays as the first player (normal, friendly, montecarlo, ismcts, expectimax, cfr, neural).", cxxopts::value<std::string>()->default_value("normal"))
+            (OPTS_BOT_DEF, "Which bot plays as the second player (normal, friendly, montecarlo, ismcts, expectimax, cfr, neural).", cxxopts::value<std::string>()->default_value("normal"))
+            (OPTS_FIRST, "Which player goes first (1 or 2).", cxxopts::value<uint8_t>()->default_value("1"))
+            (OPTS_CARDS, "Number of cards for each caravan deck (30-162, inclusive).", cxxopts::value<uint8_t>()->default_value("54"))
+            (OPTS_SAMPLES, "Number of traditional decks to sample when building caravan decks (1-3, inclusive).", cxxopts::value<uint8_t>()->default_value("1"))
+            (OPTS_IMBALANCED,
+             "An imbalanced caravan deck is built by taking as many "
+             "cards from one shuffled sample deck before moving to the next. "
+             "A balanced deck randomly samples cards across all sample decks.")
+            (OPTS_SEED, "Seed for the first game's decks and bots, with each later game using the next seed (0 is random).", cxxopts::value<uint64_t>()->default_value("0"))
+            (OPTS_OUTPUT, "Write every position, the move played and the winner to self-play shards at this path prefix.", cxxopts::value<std::string>()->default_value(""))
+            (OPTS_SHARD_RECORDS, "Most positions in each self-play shard.", cxxopts::value<uint64_t>()->default_value(std::to_string(SHARD_RECORDS_DEFAULT)))
+        ;
+
+        auto result = options.parse(argc, argv);
+
+        // Print help instructions.
+        if (result.count(KEY_HELP)) {
+            printf("%s-sim v%s\n\n", CARAVAN_NAME, CARAVAN_VERSION);
+            printf("Plays bot vs bot games without a view and reports the results,\n");
+            printf("optionally writing every position to self-play shards for training.\n");
+            printf("%s\n", CARAVAN_COPYRIGHT);
+            printf("%s\n", CARAVAN_URL);
+            printf("%s", options.help().c_str());
+            exit(EXIT_SUCCESS);
+        }
+
+        if (result.count(KEY_VERSION)) {
+            printf("%s\n", CARAVAN_VERSION);
+            exit(EXIT_SUCCESS);
+        }
+
+        uint32_t games = result[KEY_GAMES].as<uint32_t>();
+        threads = result[KEY_THREADS].as<uint32_t>();
+        std::string bot_abc = result[KEY_BOT_ABC].as<std::string>();
+        std::string bot_def = result[KEY_BOT_DEF].as<std::string>();
+        uint8_t first = result[KEY_FIRST].as<uint8_t>();
+        uint8_t cards = result[KEY_CARDS].as<uint8_t>();
+        uint8_t samples = result[KEY_SAMPLES].as<uint8_t>();
+        bool imbalanced = result[KEY_IMBALANCED].as<bool>();
+        uint64_t seed = result[KEY_SEED].as<uint64_t>();
+        std::string output = result[KEY_OUTPUT].as<std::string>();
+        uint64_t shard_records = result[KEY_SHARD_RECORDS].as<uint64_t>();
+
+        if (games == 0) {
+            printf("Number of games must be at least 1.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if(first < FIRST_ABC || first > FIRST_DEF) {
+            printf("First player must be either %d or %d.\n", FIRST_ABC, FIRST_DEF);
+            exit(EXIT_FAILURE);
+        }
+
+        if (cards < DECK_CARAVAN_MIN || cards > DECK_CARAVAN_MAX) {
+            printf("Caravan decks must have between %d and %d cards (inclusive).\n", DECK_CARAVAN_MIN, DECK_CARAVAN_MAX);
+            exit(EXIT_FAILURE);
+        }
+
+        if (samples < SAMPLE_DECKS_MIN || samples > SAMPLE_DECKS_MAX) {
+            printf("Number of caravan deck samples must be between %d and %d (inclusive).\n", SAMPLE_DECKS_MIN, SAMPLE_DECKS_MAX);
+            exit(EXIT_FAILURE);
+        }
+
+        if (shard_records == 0) {
+            printf("Number of positions in each shard must be at least 1.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // Fail on unknown bot names before any threads start
+        delete BotFactory::get(bot_abc, PLAYER_ABC);
+        delete BotFactory::get(bot_def, PLAYER_DEF);
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        threads = std::min(threads, games);
+
+        sc.gc = {
+            cards, samples, !imbalanced,
+            cards, samples, !imbalanced,
+            first == FIRST_ABC ? PLAYER_ABC : PLAYER_DEF
+        };
+        sc.bot_abc = bot_abc;
+        sc.bot_def = bot_def;
+        sc.games = games;
+        sc.seed = seed;
+        sc.output = output;
+        sc.shard_records = shard_records;
+
+    } catch (CaravanException &e) {
+        printf("%s\n", e.what().c_str());
+        exit(EXIT_FAILURE);
+
+    } catch (std::exception &e) {
+        printf("%s\n", e.what());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::thread> workers;
+    auto time_start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < threads; ++i) {
+        workers.emplace_back(run_worker, &sc, &shared, i);
+    }
+
+    for (std::thread &w: workers) {
+        w.join();
+    }
+
+    auto time_end = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(time_end - time_start).count();
+
+    if (shared.failed) {
+        printf("%s\n", shared.msg_fatal.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    SimResult *r = &shared.result;
+
+    printf("Games:       %u\n", r->games);
+    printf("Threads:     %u\n", threads);
+
+    if (sc.seed != 0) {
+        printf("Seed:        %llu\n", (unsigned long long) sc.seed);
+    }
+
+    printf("Time:        %.3f s\n", secs);
+    printf("Games/sec:   %.1f\n", secs > 0 ? r->games / secs : 0.0);
+    printf("ABC wins:    %u (%.2f%%) [%s]\n",
+           r->won_abc, 100.0 * r->won_abc / r->games, sc.bot_abc.c_str());
+    printf("DEF wins:    %u (%.2f%%) [%s]\n",
+           r->won_def, 100.0 * r->won_def / r->games, sc.bot_def.c_str());
+    printf("Avg. length: %.2f moves\n", (double) r->moves / r->games);
+
+    if (!sc.output.empty()) {
+        printf("Positions:   %llu in %u shards\n",
+               (unsigned long long) r->records, r->shards);
+        printf("Pos/sec:     %.1f\n", secs > 0 ? r->records / secs : 0.0);
+    }
+}
@@ -0,0 +1,638 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "caravan/user/bot/cfr.h"
+#include "caravan/user/bot/heuristic.h"
+#include "caravan/user/bot/playout.h"
+
+/*
+ * PRIVATE
+ */
+
+const uint32_t CFR_FILE_MAGIC = 0x31524643;  // "CFR1"
+const uint16_t CFR_PROBES_MAX = 64;  // entries tried before the table counts as full
+
+static uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t bid_bucket(uint16_t bid) {
+    if (bid == 0) { return 0; }
+    if (bid <= 12) { return 1; }
+    if (bid < CARAVAN_SOLD_MIN) { return 2; }
+    if (bid <= CARAVAN_SOLD_MAX) { return 3; }
+    return 4;
+}
+
+static CfrAction classify(PlayerCaravanNames *pcns, GameCommand *command) {
+    bool mine;
+
+    if (command->option == OPTION_DISCARD) {
+        return CFR_DISCARD;
+    }
+
+    if (command->option == OPTION_CLEAR) {
+        return CFR_CLEAR;
+    }
+
+    for (uint8_t i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
+        if (is_numeral_card(command->hand) and (*pcns)[i] == command->caravan_name) {
+            return static_cast<CfrAction>(CFR_NUMERAL_A + i);
+        }
+    }
+
+    mine = std::find(pcns->begin(), pcns->end(), command->caravan_name) != pcns->end();
+
+    switch (command->hand.rank) {
+        case KING:
+            return mine ? CFR_KING_MINE : CFR_KING_THEIRS;
+        case JACK:
+            return mine ? CFR_JACK_MINE : CFR_JACK_THEIRS;
+        case QUEEN:
+            return mine ? CFR_QUEEN_MINE : CFR_QUEEN_THEIRS;
+        default:
+            return CFR_JOKER;
+    }
+}
+
+/**
+ * Fill the policy with each legal action in proportion to its positive
+ * regret, or uniformly if none has any.
+ */
+static void regret_matching(CfrEntry *entry, uint16_t legal, CfrStrategy *policy) {
+    uint8_t num_legal = 0;
+    double total = 0;
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        (*policy)[a] = 0;
+
+        if (legal & (1 << a)) {
+            num_legal += 1;
+
+            if (entry != nullptr) {
+                (*policy)[a] = std::max(0.0f, entry->regret[a].load(std::memory_order_relaxed));
+                total += (*policy)[a];
+            }
+        }
+    }
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        if (legal & (1 << a)) {
+            (*policy)[a] = total > 0 ? (*policy)[a] / total : 1.0f / num_legal;
+        }
+    }
+}
+
+/**
+ * @return An action chosen from the legal ones with the given weights.
+ */
+static uint8_t sample_action(
+    std::array<double, CFR_ACTIONS> *weights, uint16_t legal, Random *rng) {
+
+    double total = 0;
+    uint8_t a_last = 0;
+    double u;
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        if (legal & (1 << a)) {
+            total += (*weights)[a];
+        }
+    }
+
+    u = rng->unit() * total;
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        if (legal & (1 << a)) {
+            if (u < (*weights)[a]) {
+                return a;
+            }
+
+            u -= (*weights)[a];
+            a_last = a;
+        }
+    }
+
+    // Only reached through rounding
+    return a_last;
+}
+
+/**
+ * Strategy files are large, so each is read once and shared by the bots that
+ * use it, until the last of them is closed. After that the file is read
+ * again, so new bots pick up a strategy retrained at the same path.
+ *
+ * @throws CaravanFatalException The strategy file cannot be read or is not
+ *         valid.
+ */
+static std::shared_ptr<const CfrStrategies> load_strategies(std::string path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<const CfrStrategies>> loaded;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const CfrStrategies> shared = loaded[path].lock();
+
+    if (shared) {
+        return shared;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    auto strategies = std::make_shared<CfrStrategies>();
+    uint32_t magic = 0;
+    uint32_t actions = 0;
+    uint64_t count = 0;
+
+    if (!in) {
+        throw CaravanFatalException(
+            "Could not open the strategy file '" + path + "'.");
+    }
+
+    in.read((char *) &magic, sizeof(magic));
+    in.read((char *) &actions, sizeof(actions));
+    in.read((char *) &count, sizeof(count));
+
+    if (!in or magic != CFR_FILE_MAGIC or actions != CFR_ACTIONS) {
+        throw CaravanFatalException(
+            "The strategy file '" + path + "' is not valid.");
+    }
+
+    strategies->reserve(count);
+
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t key;
+        CfrStrategy strategy;
+
+        in.read((char *) &key, sizeof(key));
+        in.read((char *) strategy.data(), sizeof(strategy));
+
+        if (!in) {
+            throw CaravanFatalException(
+                "The strategy file '" + path + "' is not valid.");
+        }
+
+        (*strategies)[key] = strategy;
+    }
+
+    loaded[path] = strategies;
+
+    return strategies;
+}
+
+/*
+ * ABSTRACTION
+ */
+
+/**
+ * @param game The game.
+ * @param pname The player whose view is abstracted.
+ * @return A key for the player's information set in the abstract game: for
+ *         each of their caravans, its bucketed bid, its direction and whether
+ *         their hand holds its suit, and whether the caravan opposite is
+ *         unsold, sold or bust; then how many numerals and what kinds of face
+ *         card are in their hand. The key is never 0.
+ */
+uint64_t cfr_info_key(Game *game, PlayerName pname) {
+    Table *table = game->table();
+    Player *p = game->player(pname);
+    PlayerCaravanNames pcns = game->get_player_caravan_names(pname);
+    Hand hand = p->hand();
+    uint8_t size_hand = p->size_hand();
+    uint64_t numerals = 0;
+    uint64_t faces = 0;
+    uint64_t key = 1;
+
+    for (CaravanName cvname: pcns) {
+        Caravan *mine = table->caravan(cvname);
+        Caravan *theirs = table->caravan(Game::get_opposite_caravan_name(cvname));
+        uint64_t suited = 0;
+
+        // Whether the hand can follow the caravan's suit matters more than
+        // which suit it is
+        for (uint8_t i = 0; i < size_hand; ++i) {
+            suited |= mine->suit() != NO_SUIT and hand[i].suit == mine->suit();
+        }
+
+        key = key * 5 + bid_bucket(mine->bid());
+        key = key * 3 + mine->direction();
+        key = key * 2 + suited;
+        key = key * 3 + std::max(bid_bucket(theirs->bid()), (uint64_t) 2) - 2;
+    }
+
+    for (uint8_t i = 0; i < size_hand; ++i) {
+        if (is_numeral_card(hand[i])) {
+            numerals += 1;
+        } else if (hand[i].rank == KING or hand[i].rank == JACK) {
+            faces |= hand[i].rank == KING ? 1 : 2;
+        } else {
+            faces |= 4;
+        }
+    }
+
+    key = key * 3 + std::min(numerals, (uint64_t) 2);
+    key = key * 8 + faces;
+    key = key * 2 + (p->moves_count() < MOVES_START_ROUND ? 1 : 0);
+
+    return key;
+}
+
+/**
+ * Find the move that each action stands for, if any.
+ *
+ * @param game The game.
+ * @param pname The player to move.
+ * @param moves Filled with the highest scoring legal move of each action.
+ * @return A bit for each action that has a legal move.
+ */
+uint16_t cfr_actions(Game *game, PlayerName pname, CfrMoves *moves) {
+    PlayerCaravanNames pcns = game->get_player_caravan_names(pname);
+    std::array<int16_t, CFR_ACTIONS> scores{};
+    GameCommandList legal_moves;
+    uint16_t legal = 0;
+
+    game->legal_moves(pname, &legal_moves);
+
+    for (uint8_t i = 0; i < legal_moves.size; ++i) {
+        GameCommand *command = &legal_moves.commands[i];
+        CfrAction a = classify(&pcns, command);
+        int16_t score = score_move(game, pname, command);
+
+        if (!(legal & (1 << a)) or score > scores[a]) {
+            (*moves)[a] = *command;
+            scores[a] = score;
+            legal |= 1 << a;
+        }
+    }
+
+    return legal;
+}
+
+/*
+ * TRAINING
+ */
+
+/**
+ * Update the table entry of one step of a sampled trajectory: the regrets of
+ * the updated player, or the average strategy of the other player.
+ *
+ * @param step The step, as it was played.
+ * @param update The player whose regrets are being updated.
+ * @param value The sampled value of the position after the step, for the
+ *        updated player.
+ * @return The sampled value of the position before the step.
+ */
+double cfr_update(CfrStep *step, PlayerName update, double value) {
+    double value_action = value / step->prob_sample;
+    double value_estimate = step->policy[step->action] * value_action;
+    double weight = step->reach_other / step->reach_sample;
+
+    if (step->entry == nullptr) {
+        return value_estimate;
+    }
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        if (!(step->legal & (1 << a))) {
+            continue;
+        }
+
+        if (step->player == update) {
+            double regret = (a == step->action ? value_action : 0) - value_estimate;
+            step->entry->regret[a].fetch_add(regret * weight, std::memory_order_relaxed);
+
+        } else {
+            step->entry->strategy[a].fetch_add(step->policy[a] * weight, std::memory_order_relaxed);
+        }
+    }
+
+    return value_estimate;
+}
+
+/**
+ * A fixed size table of regrets and average strategies that many threads can
+ * update at once without locks. Entries are claimed by compare-and-swap on
+ * their key and never removed.
+ *
+ * @param bits The table holds 2^bits entries.
+ *
+ * @throws CaravanFatalException Bits is 0 or more than CFR_TABLE_BITS_MAX.
+ */
+CfrTable::CfrTable(uint8_t bits) {
+    if (bits == 0 or bits > CFR_TABLE_BITS_MAX) {
+        throw CaravanFatalException(
+            "A strategy table must have between 1 and 32 bits of capacity.");
+    }
+
+    capacity = 1ULL << bits;
+    entries = new CfrEntry[capacity];
+    closed = false;
+}
+
+void CfrTable::close() {
+    if (!closed) {
+        delete[] entries;
+        closed = true;
+    }
+}
+
+/**
+ * @param key An information set key.
+ * @param insert If true, an entry is claimed for the key if it has none.
+ * @return The key's entry, or nullptr if it has none and either insert is
+ *         false or the table is too full.
+ */
+CfrEntry *CfrTable::find(uint64_t key, bool insert) {
+    if (closed) { throw CaravanFatalException("Strategy table is closed."); }
+
+    uint64_t mask = capacity - 1;
+    uint64_t i = mix(key) & mask;
+
+    for (uint16_t probe = 0; probe < CFR_PROBES_MAX; ++probe, i = (i + 1) & mask) {
+        uint64_t k = entries[i].key.load(std::memory_order_acquire);
+
+        if (k == key) {
+            return &entries[i];
+        }
+
+        if (k == 0) {
+            if (!insert) {
+                return nullptr;
+            }
+
+            if (entries[i].key.compare_exchange_strong(k, key, std::memory_order_acq_rel)) {
+                size.fetch_add(1, std::memory_order_relaxed);
+                return &entries[i];
+            }
+
+            // Another thread claimed it first, perhaps for the same key
+            if (k == key) {
+                return &entries[i];
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+uint64_t CfrTable::get_capacity() {
+    if (closed) { throw CaravanFatalException("Strategy table is closed."); }
+    return capacity;
+}
+
+uint64_t CfrTable::get_size() {
+    if (closed) { throw CaravanFatalException("Strategy table is closed."); }
+    return size.load(std::memory_order_relaxed);
+}
+
+/**
+ * Write the normalised average strategy of every information set that has
+ * one, in the format UserBotCfr loads. Numbers are in native byte order.
+ *
+ * @param path The file to write.
+ *
+ * @throws CaravanFatalException The file cannot be written.
+ */
+void CfrTable::save(std::string path) {
+    if (closed) { throw CaravanFatalException("Strategy table is closed."); }
+
+    std::ofstream out(path, std::ios::binary);
+    uint32_t actions = CFR_ACTIONS;
+    uint64_t count = 0;
+
+    for (uint64_t i = 0; i < capacity; ++i) {
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            if (entries[i].strategy[a].load() > 0) {
+                count += 1;
+                break;
+            }
+        }
+    }
+
+    out.write((char *) &CFR_FILE_MAGIC, sizeof(CFR_FILE_MAGIC));
+    out.write((char *) &actions, sizeof(actions));
+    out.write((char *) &count, sizeof(count));
+
+    for (uint64_t i = 0; i < capacity; ++i) {
+        uint64_t key = entries[i].key.load();
+        CfrStrategy strategy;
+        double total = 0;
+
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            strategy[a] = std::max(0.0f, entries[i].strategy[a].load());
+            total += strategy[a];
+        }
+
+        if (total > 0) {
+            for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+                strategy[a] /= total;
+            }
+
+            out.write((char *) &key, sizeof(key));
+            out.write((char *) strategy.data(), sizeof(strategy));
+        }
+    }
+
+    if (!out) {
+        throw CaravanFatalException(
+            "Could not write the strategy file '" + path + "'.");
+    }
+}
+
+/**
+ * Trains strategies for the abstract game with outcome sampling Monte Carlo
+ * counterfactual regret minimisation. Each iteration deals a new game and
+ * plays one trajectory through it, updating one player's regrets and the
+ * other player's average strategy.
+ *
+ * @param t The table to train, which may already hold training.
+ * @param gc The configuration of every game played.
+ * @param epsilon How often the updated player explores a random action
+ *        instead of following their current strategy.
+ */
+CfrTrainer::CfrTrainer(CfrTable *t, GameConfig *gc, double epsilon) {
+    table = t;
+    config = *gc;
+    exploration = epsilon;
+}
+
+/**
+ * @param iterations The number of games to play.
+ * @param threads The number of threads to train on, or 0 for all cores.
+ * @param seed Seed for the first thread, with each later thread using the
+ *        next seed, or 0 for random seeds.
+ */
+void CfrTrainer::train(uint64_t iterations, uint8_t threads, uint64_t seed) {
+    std::vector<std::thread> workers;
+    uint32_t num_threads = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    next_iteration = 0;
+
+    for (uint32_t i = 0; i < num_threads; ++i) {
+        uint64_t seed_worker = seed == 0 ? Random::seed_from_system() : seed + i;
+        workers.emplace_back(&CfrTrainer::run_worker, this, iterations, seed_worker);
+    }
+
+    for (std::thread &w: workers) {
+        w.join();
+    }
+}
+
+/*
+ * PROTECTED
+ */
+
+void CfrTrainer::run_worker(uint64_t iterations, uint64_t seed) {
+    Random rng(seed);
+    std::vector<CfrStep> steps;
+    uint64_t i;
+
+    steps.reserve(PLAYOUT_MOVES_MAX);
+
+    while ((i = next_iteration.fetch_add(1)) < iterations) {
+        run_iteration(i, &rng, &steps);
+    }
+}
+
+void CfrTrainer::run_iteration(uint64_t i_iteration, Random *rng, std::vector<CfrStep> *steps) {
+    GameConfig gc = config;
+    PlayerName update = i_iteration % 2 == 0 ? PLAYER_ABC : PLAYER_DEF;
+    PlayerName winner = NO_PLAYER;
+    double reach_other = 1;
+    double reach_sample = 1;
+    double value;
+
+    gc.seed = rng->next();
+    Game game{&gc};
+    steps->clear();
+
+    // Play one trajectory, with the updated player exploring
+    for (uint16_t i = 0; i < PLAYOUT_MOVES_MAX; ++i) {
+        PlayerName pturn = game.get_player_turn();
+        std::array<double, CFR_ACTIONS> weights{};
+        CfrMoves moves;
+        CfrStep step;
+        uint8_t num_legal = 0;
+
+        if ((winner = game.get_winner()) != NO_PLAYER) {
+            break;
+        }
+
+        step.legal = cfr_actions(&game, pturn, &moves);
+
+        if (step.legal == 0) {
+            winner = pturn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+            break;
+        }
+
+        step.entry = table->find(cfr_info_key(&game, pturn), true);
+        step.player = pturn;
+        regret_matching(step.entry, step.legal, &step.policy);
+
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            num_legal += (step.legal >> a) & 1;
+        }
+
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            weights[a] = pturn == update ?
+                         exploration / num_legal + (1 - exploration) * step.policy[a] :
+                         step.policy[a];
+        }
+
+        step.action = sample_action(&weights, step.legal, rng);
+        step.prob_sample = weights[step.action];
+        step.reach_other = reach_other;
+        step.reach_sample = reach_sample;
+        steps->push_back(step);
+
+        if (pturn != update) {
+            reach_other *= step.policy[step.action];
+        }
+
+        reach_sample *= step.prob_sample;
+        game.play_option(&moves[step.action]);
+    }
+
+    if (winner == NO_PLAYER) {
+        winner = game.get_winner();
+    }
+
+    game.close();
+
+    // Walk back up the trajectory with an importance sampled estimate of
+    // each position's value for the updated player
+    value = winner == update ? 1 : (winner == NO_PLAYER ? 0 : -1);
+
+    for (auto step = steps->rbegin(); step != steps->rend(); ++step) {
+        value = cfr_update(&*step, update, value);
+    }
+}
+
+/*
+ * BOT
+ */
+
+/**
+ * A bot that plays a strategy trained by CfrTrainer. Positions that were
+ * never reached in training are played by score_move alone.
+ *
+ * @param pn The player name.
+ * @param path The strategy file.
+ * @param seed Seed for the bot's choices, or 0 for a random seed.
+ *
+ * @throws CaravanFatalException The strategy file cannot be read or is not
+ *         valid.
+ */
+UserBotCfr::UserBotCfr(PlayerName pn, std::string path, uint64_t seed) :
+    UserBot(pn),
+    rng(seed != 0 ? seed : Random::seed_from_system()),
+    strategies(load_strategies(path)) {}
+
+void UserBotCfr::close() {
+    if (!closed) {
+        strategies.reset();
+        closed = true;
+    }
+}
+
+GameCommand UserBotCfr::request_command(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    CfrMoves moves;
+    std::array<double, CFR_ACTIONS> weights{};
+    uint16_t legal = cfr_actions(game, name, &moves);
+    double total = 0;
+    uint8_t action = CFR_ACTIONS;
+
+    if (legal == 0) { return BOT_DISCARD_FIRST; }
+
+    auto it = strategies->find(cfr_info_key(game, name));
+
+    if (it != strategies->end()) {
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            if (legal & (1 << a)) {
+                weights[a] = it->second[a];
+                total += weights[a];
+            }
+        }
+    }
+
+    if (total > 0) {
+        action = sample_action(&weights, legal, &rng);
+
+    } else {
+        // Never trained, so play the best scoring action
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            if ((legal & (1 << a)) and
+                (action == CFR_ACTIONS or
+                 score_move(game, name, &moves[a]) > score_move(game, name, &moves[action]))) {
+                action = a;
+            }
+        }
+    }
+
+    return moves[action];
+}
@@ -0,0 +1,521 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include "caravan/user/bot/expectimax.h"
+#include "caravan/user/bot/heuristic.h"
+
+/*
+ * PRIVATE
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+const double EVAL_WIN = 1000;
+const double EVAL_LOSS = -1000;
+const double EVAL_LANE = 250;  // a caravan that is sold and outbids its opposite
+const uint16_t NODES_PER_CLOCK = 256;  // nodes searched between deadline checks
+
+typedef struct ExpectimaxSearch {
+    PlayerName me;
+    uint8_t width;
+    bool prune;  // false only to check the pruning against plain expectimax
+    Clock::time_point deadline;
+    bool use_deadline;
+    bool stopped;
+    uint32_t nodes;
+} ExpectimaxSearch;
+
+typedef struct DrawOutcome {
+    uint8_t pos_deck;  // a deck position holding the card
+    double prob;
+} DrawOutcome;
+
+static double search_decision(
+    ExpectimaxSearch *s, Game *game, uint8_t depth, double alpha, double beta);
+
+static double search_move(
+    ExpectimaxSearch *s, Game *game, GameCommand *command,
+    uint8_t depth, double alpha, double beta);
+
+/**
+ * Move the moves most worth searching to the front of the list.
+ *
+ * @return The number of moves at the front to search.
+ */
+static uint8_t order_moves(Game *game, PlayerName pturn, GameCommandList *moves, uint8_t keep) {
+    std::array<int16_t, MOVES_LEGAL_MAX> scores;
+    uint8_t size = keep < moves->size ? keep : moves->size;
+
+    for (uint8_t i = 0; i < moves->size; ++i) {
+        scores[i] = score_move(game, pturn, &moves->commands[i]);
+    }
+
+    for (uint8_t i = 0; i < size; ++i) {
+        uint8_t i_best = i;
+
+        for (uint8_t j = i + 1; j < moves->size; ++j) {
+            if (scores[j] > scores[i_best]) {
+                i_best = j;
+            }
+        }
+
+        std::swap(scores[i], scores[i_best]);
+        std::swap(moves->commands[i], moves->commands[i_best]);
+    }
+
+    return size;
+}
+
+/**
+ * @return How good the table is for a player, strictly between a loss and a
+ *         win.
+ */
+static double evaluate(Game *game, PlayerName me) {
+    PlayerCaravanNames pcns = game->get_player_caravan_names(me);
+    Table *table = game->table();
+    double value = 0;
+
+    for (CaravanName cvn_me: pcns) {
+        CaravanName cvn_opp = Game::get_opposite_caravan_name(cvn_me);
+
+        if (game->is_caravan_winning(cvn_me)) {
+            value += EVAL_LANE;
+
+        } else if (game->is_caravan_winning(cvn_opp)) {
+            value -= EVAL_LANE;
+
+        } else {
+            // Neither is winning, so credit progress towards the sold range
+            for (CaravanName cvname: {cvn_me, cvn_opp}) {
+                uint16_t bid = table->caravan(cvname)->bid();
+                double progress = bid > CARAVAN_SOLD_MAX ?
+                                  -EVAL_LANE / 4 :
+                                  EVAL_LANE / 2 * bid / CARAVAN_SOLD_MAX;
+
+                value += cvname == cvn_me ? progress : -progress;
+            }
+        }
+    }
+
+    return value;
+}
+
+static double terminal(ExpectimaxSearch *s, PlayerName winner) {
+    return winner == s->me ? EVAL_WIN : EVAL_LOSS;
+}
+
+static bool out_of_time(ExpectimaxSearch *s) {
+    s->nodes += 1;
+
+    if (s->use_deadline and s->nodes % NODES_PER_CLOCK == 0 and
+        Clock::now() >= s->deadline) {
+        s->stopped = true;
+    }
+
+    return s->stopped;
+}
+
+/**
+ * @return True if the player to move draws a card after playing the command.
+ */
+static bool draws_after(Player *p, GameCommand *command) {
+    uint8_t size_hand = p->size_hand();
+
+    if (command->option != OPTION_CLEAR) {
+        size_hand -= 1;
+    }
+
+    return p->size_deck() > 0 and
+           p->moves_count() >= MOVES_START_ROUND and
+           size_hand < HAND_SIZE_MAX_POST_START;
+}
+
+/**
+ * The value of a decision node when only its first ordered move is searched.
+ * For the player to move, it bounds the node's value from below if they
+ * maximise, or from above if they minimise.
+ */
+static double probe(ExpectimaxSearch *s, Game *game, uint8_t depth) {
+    PlayerName winner = game->get_winner();
+    PlayerName pturn = game->player_turn();
+    GameCommandList moves;
+
+    if (winner != NO_PLAYER) {
+        return terminal(s, winner);
+    }
+
+    game->legal_moves(pturn, &moves);
+
+    if (moves.size == 0) {
+        return terminal(s, pturn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC);
+    }
+
+    order_moves(game, pturn, &moves, 1);
+
+    return search_move(s, game, &moves.commands[0], depth, EVAL_LOSS, EVAL_WIN);
+}
+
+/**
+ * The value of a move that draws a card, averaged over every card that could
+ * be drawn. Star2 first probes each outcome to bound the average and cut off
+ * early, then Star1 narrows each outcome's window by what is known of the
+ * others.
+ */
+static double search_chance(
+    ExpectimaxSearch *s, Game *game, GameCommand *command,
+    uint8_t depth, double alpha, double beta) {
+
+    PlayerName pturn = game->player_turn();
+    Player *p = game->player(pturn);
+    bool maximise_next = pturn != s->me;
+    std::array<std::array<uint8_t, JOKER + 1>, SPADES + 1> i_outcome{};
+    std::array<DrawOutcome, DECK_TRADITIONAL_MAX> outcomes;
+    std::array<double, DECK_TRADITIONAL_MAX> lo;
+    std::array<double, DECK_TRADITIONAL_MAX> hi;
+    uint8_t num_outcomes = 0;
+    uint8_t size_deck = p->size_deck();
+    double rest_lo = 0;
+    double rest_hi = 0;
+    double sum = 0;
+    GameUndo undo;
+
+    // Every distinct card in the deck is one outcome
+    for (uint8_t pos = 1; pos <= size_deck; ++pos) {
+        Card c = p->get_from_deck_at(pos);
+        uint8_t *i = &i_outcome[c.suit][c.rank];
+
+        if (*i == 0) {
+            outcomes[num_outcomes] = {pos, 0};
+            num_outcomes += 1;
+            *i = num_outcomes;
+        }
+
+        outcomes[*i - 1].prob += 1.0 / size_deck;
+    }
+
+    // Likely outcomes first, as they narrow the windows the most
+    for (uint8_t i = 1; i < num_outcomes; ++i) {
+        for (uint8_t j = i; j > 0 and outcomes[j].prob > outcomes[j - 1].prob; --j) {
+            std::swap(outcomes[j], outcomes[j - 1]);
+        }
+    }
+
+    if (!s->prune) {
+        for (uint8_t i = 0; i < num_outcomes; ++i) {
+            p->swap_with_deck_top(outcomes[i].pos_deck);
+            game->play_option(command, &undo);
+
+            sum += outcomes[i].prob * search_decision(s, game, depth - 1, EVAL_LOSS, EVAL_WIN);
+
+            game->unplay(&undo);
+            p->swap_with_deck_top(outcomes[i].pos_deck);
+
+            if (s->stopped) { return 0; }
+        }
+
+        return sum;
+    }
+
+    // Star2: the next player's first move bounds each outcome on one side
+    for (uint8_t i = 0; i < num_outcomes; ++i) {
+        p->swap_with_deck_top(outcomes[i].pos_deck);
+        game->play_option(command, &undo);
+
+        double bound = probe(s, game, depth - 1);
+
+        game->unplay(&undo);
+        p->swap_with_deck_top(outcomes[i].pos_deck);
+
+        if (s->stopped) { return 0; }
+
+        lo[i] = maximise_next ? bound : EVAL_LOSS;
+        hi[i] = maximise_next ? EVAL_WIN : bound;
+        rest_lo += outcomes[i].prob * lo[i];
+        rest_hi += outcomes[i].prob * hi[i];
+    }
+
+    if (rest_lo >= beta) { return rest_lo; }
+    if (rest_hi <= alpha) { return rest_hi; }
+
+    // Star1: search each outcome in the window that could still change
+    // whether the average falls inside alpha and beta
+    for (uint8_t i = 0; i < num_outcomes; ++i) {
+        double prob = outcomes[i].prob;
+        double a;
+        double b;
+        double v;
+
+        rest_lo -= prob * lo[i];
+        rest_hi -= prob * hi[i];
+
+        a = (alpha - sum - rest_hi) / prob;
+        b = (beta - sum - rest_lo) / prob;
+
+        // Rounding can leave no window, but then the bounds already decide
+        if (lo[i] >= b) { return sum + prob * lo[i] + rest_lo; }
+        if (hi[i] <= a) { return sum + prob * hi[i] + rest_hi; }
+
+        if (lo[i] >= hi[i]) {
+            // The probe found a certain win or loss
+            v = lo[i];
+
+        } else {
+            p->swap_with_deck_top(outcomes[i].pos_deck);
+            game->play_option(command, &undo);
+
+            v = search_decision(
+                s, game, depth - 1,
+                a > lo[i] ? a : lo[i],
+                b < hi[i] ? b : hi[i]);
+
+            game->unplay(&undo);
+            p->swap_with_deck_top(outcomes[i].pos_deck);
+
+            if (s->stopped) { return 0; }
+        }
+
+        if (v <= a) { return sum + prob * v + rest_hi; }
+        if (v >= b) { return sum + prob * v + rest_lo; }
+
+        sum += prob * v;
+    }
+
+    return sum;
+}
+
+/**
+ * @param depth The number of moves left to search, including this one.
+ * @return The value of playing the command in the current position.
+ */
+static double search_move(
+    ExpectimaxSearch *s, Game *game, GameCommand *command,
+    uint8_t depth, double alpha, double beta) {
+
+    GameUndo undo;
+    double v;
+
+    // The card drawn is only played two moves later, so below that depth
+    // every draw leads to the same value
+    if (depth >= 3 and draws_after(game->player(game->player_turn()), command)) {
+        return search_chance(s, game, command, depth, alpha, beta);
+    }
+
+    game->play_option(command, &undo);
+    v = search_decision(s, game, depth - 1, alpha, beta);
+    game->unplay(&undo);
+
+    return v;
+}
+
+/**
+ * Alpha-beta over a decision node, where the bot maximises and its opponent
+ * minimises. Only the best few moves by score_move are searched.
+ */
+static double search_decision(
+    ExpectimaxSearch *s, Game *game, uint8_t depth, double alpha, double beta) {
+
+    PlayerName winner = game->get_winner();
+    PlayerName pturn;
+    GameCommandList moves;
+    uint8_t size;
+    bool maximise;
+    double best;
+
+    if (winner != NO_PLAYER) {
+        return terminal(s, winner);
+    }
+
+    if (depth == 0) {
+        return evaluate(game, s->me);
+    }
+
+    if (out_of_time(s)) { return 0; }
+
+    pturn = game->player_turn();
+    maximise = pturn == s->me;
+    game->legal_moves(pturn, &moves);
+
+    if (moves.size == 0) {
+        return terminal(s, pturn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC);
+    }
+
+    size = order_moves(game, pturn, &moves, s->width);
+    best = maximise ? EVAL_LOSS : EVAL_WIN;
+
+    for (uint8_t i = 0; i < size and (alpha < beta or !s->prune); ++i) {
+        double v = s->prune ?
+                   search_move(s, game, &moves.commands[i], depth, alpha, beta) :
+                   search_move(s, game, &moves.commands[i], depth, EVAL_LOSS, EVAL_WIN);
+
+        if (s->stopped) { return 0; }
+
+        if (maximise and v > best) {
+            best = v;
+            alpha = best > alpha ? best : alpha;
+
+        } else if (!maximise and v < best) {
+            best = v;
+            beta = best < beta ? best : beta;
+        }
+    }
+
+    return best;
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * The value of a position with no hidden cards, searched to a fixed depth in
+ * the same way as the bot searches each sample.
+ *
+ * @param game The game, which is left as it was.
+ * @param me The player whose value it is.
+ * @param depth The number of moves to search ahead.
+ * @param width The number of moves searched at each position.
+ * @param prune False to search every move and outcome in full, without
+ *        alpha-beta or Star1/Star2 pruning.
+ * @return The value, strictly between a loss and a win unless the search
+ *         finds one.
+ */
+double expectimax_value(Game *game, PlayerName me, uint8_t depth, uint8_t width, bool prune) {
+    ExpectimaxSearch search{};
+
+    search.me = me;
+    search.width = width;
+    search.prune = prune;
+
+    return search_decision(&search, game, depth, EVAL_LOSS, EVAL_WIN);
+}
+
+/**
+ * A bot that searches a few moves ahead with expectimax. The opponent's
+ * hidden cards are sampled a few times per decision, and card draws are
+ * averaged over every card left in the drawing player's deck. Searches are
+ * deepened one move at a time until the depth or time limit is reached.
+ *
+ * @param pn The player name.
+ * @param depth The most moves to search ahead.
+ * @param millis The most time per move decision, or 0 for no limit.
+ * @param samples The number of samples of the opponent's hidden cards.
+ * @param moves The number of moves searched at each position below the
+ *        first, chosen by how promising they look.
+ * @param seed Seed for the bot's choices, or 0 for a random seed.
+ *
+ * @throws CaravanFatalException Depth, samples or moves is 0.
+ */
+UserBotExpectimax::UserBotExpectimax(
+    PlayerName pn,
+    uint8_t depth,
+    uint32_t millis,
+    uint8_t samples,
+    uint8_t moves,
+    uint64_t seed) :
+    UserBot(pn),
+    rng(seed != 0 ? seed : Random::seed_from_system()),
+    max_depth(depth),
+    max_millis(millis),
+    num_samples(samples),
+    width(moves) {
+
+    if (max_depth == 0 or num_samples == 0 or width == 0) {
+        throw CaravanFatalException(
+            "The bot must search at least one move in one sample.");
+    }
+}
+
+void UserBotExpectimax::close() {
+    if (!closed) {
+        closed = true;
+    }
+}
+
+GameCommand UserBotExpectimax::request_command(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    ExpectimaxSearch search{};
+    GameState root = game->clone();
+    std::vector<Game *> samples;
+    GameCommandList moves;
+
+    game->legal_moves(name, &moves);
+
+    if (moves.size == 0) { return BOT_DISCARD_FIRST; }
+    if (moves.size == 1) { return moves.commands[0]; }
+
+    search.me = name;
+    search.width = width;
+    search.prune = true;
+    search.use_deadline = max_millis > 0;
+    search.deadline = Clock::now() + std::chrono::milliseconds(max_millis);
+
+    // The bot's own hand is the same in every sample, so its moves are too
+    for (uint8_t i = 0; i < num_samples; ++i) {
+        samples.push_back(new Game(&root));
+        samples.back()->determinize(name, &rng);
+    }
+
+    order_moves(game, name, &moves, moves.size);
+
+    for (uint8_t depth = 1; depth <= max_depth and !search.stopped; ++depth) {
+        double value_best = EVAL_LOSS;
+        uint8_t i_best = 0;
+        uint8_t num_searched = 0;
+
+        for (uint8_t i = 0; i < moves.size and value_best < EVAL_WIN; ++i) {
+            // Each sample is equally likely, so Star1 applies across them
+            double prob = 1.0 / num_samples;
+            double rest_hi = EVAL_WIN;
+            double sum = 0;
+            bool cut = false;
+
+            for (Game *sample: samples) {
+                rest_hi -= prob * EVAL_WIN;
+
+                double a = (value_best - sum - rest_hi) / prob;
+                double v = search_move(
+                    &search, sample, &moves.commands[i], depth,
+                    a > EVAL_LOSS ? a : EVAL_LOSS, EVAL_WIN);
+
+                if (search.stopped or v <= a) {
+                    cut = true;
+                    break;
+                }
+
+                sum += prob * v;
+            }
+
+            if (search.stopped) { break; }
+
+            num_searched += 1;
+
+            if (!cut and sum > value_best) {
+                value_best = sum;
+                i_best = i;
+            }
+        }
+
+        // The last best move is searched first, so a partly searched depth
+        // only ever replaces it with a better move
+        if (num_searched > 0) {
+            std::swap(moves.commands[0], moves.commands[i_best]);
+        }
+
+        if (value_best >= EVAL_WIN or value_best <= EVAL_LOSS) {
+            break;
+        }
+    }
+
+    for (Game *sample: samples) {
+        sample->close();
+        delete sample;
+    }
+
+    return moves.commands[0];
+}
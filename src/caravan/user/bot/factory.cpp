@@ -9,11 +9,35 @@
 #include "caravan/user/bot/factory.h"
 #include "caravan/user/bot/normal.h"
 #include "caravan/user/bot/friendly.h"
+#include "caravan/user/bot/montecarlo.h"
+#include "caravan/user/bot/ismcts.h"
+#include "caravan/user/bot/expectimax.h"
+#include "caravan/user/bot/cfr.h"
+#include "caravan/user/bot/neural.h"
 
 const std::string NAME_NORMAL = "normal";
 const std::string NAME_FRIENDLY = "friendly";
+const std::string NAME_MONTECARLO = "montecarlo";
+const std::string NAME_ISMCTS = "ismcts";
+const std::string NAME_EXPECTIMAX = "expectimax";
+const std::string NAME_CFR = "cfr";
+const std::string NAME_NEURAL = "neural";
 
-UserBot* BotFactory::get(std::string name, PlayerName player_name) {
+/**
+ * @param name The bot's name, in any case.
+ * @param player_name The player the bot plays as.
+ * @param seed Seed for the bot's choices, or 0 for a random seed.
+ * @param headless If true, search bots run on one thread and stop on their
+ *        playout, iteration or depth budget rather than the clock, so that
+ *        a seeded game always plays out the same way. Otherwise, they use
+ *        every core for a second per move.
+ * @return The bot.
+ *
+ * @throws CaravanFatalException Unknown bot name.
+ */
+UserBot* BotFactory::get(
+    std::string name, PlayerName player_name,
+    uint64_t seed, bool headless) {
     // Set name to lowercase
     std::transform(
         name.begin(), name.end(), name.begin(),
@@ -22,6 +46,36 @@ UserBot* BotFactory::get(std::string name, PlayerName player_name) {
     // Return bot that matches name, or fail
     if(name == NAME_NORMAL) { return new UserBotNormal(player_name); }
     if(name == NAME_FRIENDLY) { return new UserBotFriendly(player_name); }
+    if(name == NAME_MONTECARLO) {
+        return headless ?
+            new UserBotMonteCarlo(
+                player_name, MONTECARLO_PLAYOUTS_DEFAULT, 0, 1, true, seed) :
+            new UserBotMonteCarlo(
+                player_name, MONTECARLO_PLAYOUTS_DEFAULT,
+                MONTECARLO_MILLIS_DEFAULT, 0, true, seed);
+    }
+    if(name == NAME_ISMCTS) {
+        return headless ?
+            new UserBotIsmcts(
+                player_name, ISMCTS_ITERATIONS_DEFAULT, 0, 1, seed) :
+            new UserBotIsmcts(
+                player_name, ISMCTS_ITERATIONS_DEFAULT,
+                ISMCTS_MILLIS_DEFAULT, 0, seed);
+    }
+    if(name == NAME_EXPECTIMAX) {
+        return headless ?
+            new UserBotExpectimax(
+                player_name, EXPECTIMAX_DEPTH_HEADLESS, 0,
+                EXPECTIMAX_SAMPLES_DEFAULT, EXPECTIMAX_WIDTH_DEFAULT, seed) :
+            new UserBotExpectimax(
+                player_name, EXPECTIMAX_DEPTH_DEFAULT,
+                EXPECTIMAX_MILLIS_DEFAULT,
+                EXPECTIMAX_SAMPLES_DEFAULT, EXPECTIMAX_WIDTH_DEFAULT, seed);
+    }
+    if(name == NAME_CFR) {
+        return new UserBotCfr(player_name, CFR_STRATEGY_DEFAULT, seed);
+    }
+    if(name == NAME_NEURAL) { return new UserBotNeural(player_name); }
     else {
         throw CaravanFatalException("Unknown bot name '" + name + "'.");
     }
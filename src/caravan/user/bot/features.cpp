@@ -0,0 +1,117 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <cstring>
+#include "caravan/user/bot/features.h"
+
+const float FEATURES_MOVES_MAX = 100;
+
+/*
+ * PRIVATE
+ */
+
+static void encode_suit(Suit suit, float *out) {
+    if (suit != NO_SUIT) {
+        out[suit - CLUBS] = 1;
+    }
+}
+
+static bool is_sold(uint16_t bid) {
+    return bid >= CARAVAN_SOLD_MIN and bid <= CARAVAN_SOLD_MAX;
+}
+
+static float *encode_caravan(Table *table, CaravanName cvname, float *out) {
+    Caravan *cvn = table->caravan(cvname);
+    uint8_t size = cvn->size();
+    uint16_t bid = cvn->bid();
+    uint16_t bid_opp = table->caravan(Game::get_opposite_caravan_name(cvname))->bid();
+
+    for (uint8_t pos = 1; pos <= size; ++pos) {
+        Slot slot = cvn->slot(pos);
+        float *s = out + (pos - 1) * FEATURES_SLOT;
+        uint8_t kings = 0;
+
+        for (uint8_t f = 0; f < slot.i_faces; ++f) {
+            if (slot.faces[f].rank == KING) {
+                kings += 1;
+            }
+        }
+
+        s[0] = 1;
+        s[1] = card_value(slot.card) / 10.0f;
+        encode_suit(slot.card.suit, s + 2);
+        s[6] = kings / (float) TRACK_FACE_MAX;
+    }
+
+    out += FEATURES_SLOT * TRACK_NUMERIC_MAX;
+
+    out[0] = bid / (float) CARAVAN_SOLD_MAX;
+    out[1] = is_sold(bid);
+    out[2] = bid > CARAVAN_SOLD_MAX;
+    out[3] = is_sold(bid) and (!is_sold(bid_opp) or bid > bid_opp);
+    out[4] = size / (float) TRACK_NUMERIC_MAX;
+    out[5 + cvn->direction()] = 1;
+    encode_suit(cvn->suit(), out + 8);
+
+    return out + 12;
+}
+
+static float *encode_counts(Player *player, float *out) {
+    out[0] = player->size_deck() / (float) DECK_CARAVAN_MAX;
+    out[1] = player->size_hand() / (float) HAND_SIZE_MAX_START;
+    out[2] = std::min(player->moves_count() / FEATURES_MOVES_MAX, 1.0f);
+    out[3] = player->moves_count() < MOVES_START_ROUND;
+
+    return out + 4;
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * Encode what a player can see of a game into a fixed-length vector, such
+ * as for a neural network. The player's caravans come first, then the
+ * opposite caravans in the same order, so both players see the table the
+ * same way. Hidden cards (the opponent's hand and both decks) are only
+ * counted, so determinizing the game leaves the features unchanged.
+ *
+ * @param game The game.
+ * @param pname The player whose view is encoded.
+ * @param features The encoded view, with values roughly between 0 and 1.
+ *
+ * @throws CaravanFatalException Invalid player name.
+ */
+void encode_features(Game *game, PlayerName pname, Features *features) {
+    PlayerCaravanNames pcns = game->get_player_caravan_names(pname);
+    PlayerName pname_opp = pname == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+    Player *player = game->player(pname);
+    Table *table = game->table();
+    Hand hand = player->hand();
+    uint8_t size_hand = player->size_hand();
+    float *out = features->data();
+
+    std::memset(features->data(), 0, sizeof(Features));
+
+    for (CaravanName cvname: pcns) {
+        out = encode_caravan(table, cvname, out);
+    }
+
+    for (CaravanName cvname: pcns) {
+        out = encode_caravan(table, Game::get_opposite_caravan_name(cvname), out);
+    }
+
+    for (uint8_t i = 0; i < size_hand; ++i) {
+        out[hand[i].rank] += 1.0f / HAND_SIZE_MAX_START;
+
+        if (hand[i].suit != NO_SUIT) {
+            out[14 + hand[i].suit - CLUBS] += 1.0f / HAND_SIZE_MAX_START;
+        }
+    }
+
+    out = encode_counts(player, out + FEATURES_HAND);
+    out = encode_counts(game->player(pname_opp), out);
+    out[0] = game->player_turn() == pname;
+}
@@ -9,14 +9,14 @@
  * PUBLIC
  */
 
-std::string UserBotFriendly::request_move(Game *game) {
+GameCommand UserBotFriendly::request_command(Game *game) {
     if (closed) { throw CaravanFatalException("Bot is closed."); }
 
-    std::string move = generate_move(game, true, false, true);
+    GameCommand move = generate_move(game, true, false, true);
 
     // Return move if able to generate one
-    if (!move.empty()) { return move; }
+    if (move.option != NO_OPTION) { return move; }
 
     // If no useful move could be made, discard first card in hand
-    return "D1";
+    return BOT_DISCARD_FIRST;
 }
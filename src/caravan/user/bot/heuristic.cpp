@@ -0,0 +1,99 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "caravan/user/bot/heuristic.h"
+
+/*
+ * PRIVATE
+ */
+
+static uint16_t slot_value(Slot slot) {
+    uint16_t value = card_value(slot.card);
+
+    for (uint8_t f = 0; f < slot.i_faces; ++f) {
+        if (slot.faces[f].rank == KING) {
+            value <<= 1;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @return How good a bid is for the caravan's owner.
+ */
+static int16_t bid_score(int16_t bid) {
+    if (bid > CARAVAN_SOLD_MAX) {
+        return -150;
+    }
+
+    if (bid >= CARAVAN_SOLD_MIN) {
+        return 200;
+    }
+
+    return bid * 4;
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * A cheap guess at how good a move is, in the spirit of the normal bot:
+ * clear stuck caravans, bring own caravans towards the sold range while
+ * following their suit, and push the opponent's caravans out of it with face
+ * cards.
+ *
+ * @param game The game in which the move would be played.
+ * @param pname The player making the move.
+ * @param command A legal move.
+ * @return The move's score, where higher is better.
+ */
+int16_t score_move(Game *game, PlayerName pname, GameCommand *command) {
+    Table *table = game->table();
+    PlayerCaravanNames pcns = game->get_player_caravan_names(pname);
+    Caravan *cvn;
+    bool mine;
+    int16_t bid;
+    int16_t bid_after;
+    int16_t score;
+
+    if (command->option == OPTION_DISCARD) {
+        return -100;
+    }
+
+    cvn = table->caravan(command->caravan_name);
+    bid = cvn->bid();
+
+    if (command->option == OPTION_CLEAR) {
+        return bid > CARAVAN_SOLD_MAX or cvn->size() == TRACK_NUMERIC_MAX ? 300 : -200;
+    }
+
+    if (is_numeral_card(command->hand)) {
+        bid_after = bid + card_value(command->hand);
+        score = bid_score(bid_after) - bid_score(bid);
+
+        return cvn->suit() == command->hand.suit ? score + 20 : score;
+    }
+
+    mine = command->caravan_name == pcns[0] or
+           command->caravan_name == pcns[1] or
+           command->caravan_name == pcns[2];
+
+    switch (command->hand.rank) {
+        case KING:
+            bid_after = bid + slot_value(cvn->slot(command->pos_caravan));
+            break;
+        case JACK:
+            bid_after = bid - slot_value(cvn->slot(command->pos_caravan));
+            break;
+        default:
+            // Queens and jokers change what can follow rather than the bid
+            return mine ? -10 : 10;
+    }
+
+    score = bid_score(bid_after) - bid_score(bid);
+
+    return mine ? score : -score;
+}
@@ -0,0 +1,472 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "caravan/user/bot/ismcts.h"
+#include "caravan/user/bot/normal.h"
+#include "caravan/user/bot/playout.h"
+
+/*
+ * PRIVATE
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+typedef struct IsmctsShared {
+    GameState root;
+    PlayerName me;
+    uint32_t max_iterations;
+    Clock::time_point deadline;
+    bool use_deadline;
+
+    std::atomic<uint32_t> next_iteration{0};
+    std::atomic<bool> stop{false};
+} IsmctsShared;
+
+/**
+ * @return True if both commands play the same card in the same way. Hand
+ *         positions are ignored.
+ */
+static bool same_move(GameCommand *a, GameCommand *b) {
+    return a->option == b->option and
+           a->hand.suit == b->hand.suit and
+           a->hand.rank == b->hand.rank and
+           a->caravan_name == b->caravan_name and
+           a->pos_caravan == b->pos_caravan;
+}
+
+static IsmctsNode *find_child(IsmctsNode *node, GameCommand *move) {
+    for (IsmctsNode *child: node->children) {
+        if (same_move(&child->move, move)) {
+            return child;
+        }
+    }
+
+    return nullptr;
+}
+
+static void delete_node(IsmctsNode *node) {
+    for (IsmctsNode *child: node->children) {
+        delete_node(child);
+    }
+
+    delete node;
+}
+
+/**
+ * Detach a node from its parent and delete the rest of the parent's tree.
+ *
+ * @return The node, now the root of its own tree.
+ */
+static IsmctsNode *detach(IsmctsNode *root, IsmctsNode *node) {
+    IsmctsNode *parent = node->parent;
+
+    parent->children.erase(
+        std::find(parent->children.begin(), parent->children.end(), node));
+    delete_node(root);
+    node->parent = nullptr;
+
+    return node;
+}
+
+/**
+ * Grow one tree from its root. Every iteration samples the hidden cards
+ * anew, so only the moves that are legal in that sample are considered, and
+ * a move's availability counts how often it could have been chosen.
+ */
+static void run_iterations(IsmctsShared *shared, IsmctsNode *root, uint64_t seed) {
+    Random rng(seed);
+    Game game{&shared->root};
+    UserBotNormal bot_abc{PLAYER_ABC};
+    UserBotNormal bot_def{PLAYER_DEF};
+    GameCommandList moves;
+    GameCommandList untried;
+
+    while ((shared->max_iterations == 0 or
+            shared->next_iteration.fetch_add(1) < shared->max_iterations) and
+           (!shared->use_deadline or Clock::now() < shared->deadline) and
+           !shared->stop.load(std::memory_order_relaxed)) {
+
+        IsmctsNode *node = root;
+        PlayerName winner = NO_PLAYER;
+        bool expanded = false;
+
+        game.restore(&shared->root);
+        game.determinize(shared->me, &rng);
+
+        // Select moves down the tree until one is expanded
+        while (!expanded and (winner = game.get_winner()) == NO_PLAYER) {
+            PlayerName pturn = game.get_player_turn();
+            IsmctsNode *best = nullptr;
+            double score_best = -1;
+
+            game.legal_moves(pturn, &moves);
+
+            if (moves.size == 0) {
+                winner = pturn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+                break;
+            }
+
+            untried.size = 0;
+
+            for (uint8_t i = 0; i < moves.size; ++i) {
+                IsmctsNode *child = find_child(node, &moves.commands[i]);
+
+                if (child == nullptr) {
+                    untried.commands[untried.size] = moves.commands[i];
+                    untried.size += 1;
+
+                } else {
+                    // A card held twice gives the same child twice
+                    bool counted = false;
+
+                    for (uint8_t j = 0; j < i and !counted; ++j) {
+                        counted = same_move(&moves.commands[j], &moves.commands[i]);
+                    }
+
+                    if (counted) { continue; }
+
+                    child->avail += 1;
+
+                    double score =
+                        child->reward / child->visits +
+                        ISMCTS_EXPLORATION * std::sqrt(std::log(child->avail) / child->visits);
+
+                    if (score > score_best) {
+                        best = child;
+                        score_best = score;
+                    }
+                }
+            }
+
+            GameCommand command;
+
+            if (untried.size > 0) {
+                command = untried.commands[rng.below(untried.size)];
+
+                best = new IsmctsNode();
+                best->move = command;
+                best->move.pos_hand = 0;
+                best->mover = pturn;
+                best->avail = 1;
+                best->parent = node;
+                node->children.push_back(best);
+
+                expanded = true;
+
+            } else {
+                command = best->move;
+
+                // Play the card from wherever it is in this sample's hand
+                for (uint8_t i = 0; i < moves.size; ++i) {
+                    if (same_move(&moves.commands[i], &best->move)) {
+                        command.pos_hand = moves.commands[i].pos_hand;
+                        break;
+                    }
+                }
+            }
+
+            game.play_option(&command);
+            node = best;
+        }
+
+        if (expanded and winner == NO_PLAYER) {
+            winner = playout(&game, &rng, &bot_abc, &bot_def);
+        }
+
+        for (; node != nullptr; node = node->parent) {
+            node->visits += 1;
+            node->reward += node->mover == winner ? 1 : (winner == NO_PLAYER ? 0.5 : 0);
+        }
+    }
+
+    bot_abc.close();
+    bot_def.close();
+    game.close();
+}
+
+/*
+ * PROTECTED
+ */
+
+/**
+ * Keep each tree's subtree for the bot's last move, so that the trees start
+ * from the opponent's turn.
+ *
+ * @param game The game, just after the bot's last move.
+ */
+void UserBotIsmcts::follow_own_move(Game *game) {
+    for (IsmctsNode *&tree: trees) {
+        IsmctsNode *mine = find_child(tree, &last_move);
+
+        if (mine != nullptr) {
+            tree = detach(tree, mine);
+        } else {
+            delete_node(tree);
+            tree = new IsmctsNode();
+        }
+    }
+
+    last_state = game->clone();
+    pondered = true;
+}
+
+/**
+ * Keep each tree's subtree for the moves played since the last decision: the
+ * bot's own move, unless the trees already follow it from pondering, and the
+ * opponent's reply. The reply is found by replaying each of the opponent's
+ * legal moves from the position after the bot's move until one gives the
+ * current position.
+ */
+void UserBotIsmcts::reuse_trees(Game *game) {
+    GameState gs = last_state;
+    Game replay{&gs};
+    GameState gs_mine;
+    GameCommandList moves;
+    GameCommand reply{};
+    bool found = false;
+    uint64_t hash_now = game->get_hash();
+
+    if (!pondered) {
+        replay.play_option(&last_move);
+    }
+
+    gs_mine = replay.clone();
+
+    if (replay.get_winner() == NO_PLAYER) {
+        replay.legal_moves(replay.get_player_turn(), &moves);
+
+        for (uint8_t i = 0; i < moves.size and !found; ++i) {
+            reply = moves.commands[i];
+            replay.restore(&gs_mine);
+            replay.play_option(&reply);
+            found = replay.get_hash() == hash_now;
+        }
+    }
+
+    replay.close();
+
+    for (IsmctsNode *&tree: trees) {
+        IsmctsNode *mine = !found ? nullptr : (pondered ? tree : find_child(tree, &last_move));
+        IsmctsNode *theirs = mine != nullptr ? find_child(mine, &reply) : nullptr;
+
+        if (theirs != nullptr) {
+            tree = detach(tree, theirs);
+        } else {
+            delete_node(tree);
+            tree = new IsmctsNode();
+        }
+    }
+}
+
+void UserBotIsmcts::delete_trees() {
+    for (IsmctsNode *tree: trees) {
+        delete_node(tree);
+    }
+
+    trees.clear();
+}
+
+/**
+ * Stop searching during the opponent's turn, if the bot is, and wait for its
+ * threads to finish.
+ */
+void UserBotIsmcts::stop_pondering() {
+    if (ponder_shared == nullptr) { return; }
+
+    ponder_shared->stop = true;
+
+    for (std::thread &w: ponder_workers) {
+        w.join();
+    }
+
+    ponder_workers.clear();
+    delete ponder_shared;
+    ponder_shared = nullptr;
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * A bot that searches with information set Monte Carlo tree search. Every
+ * thread grows its own tree over random samples of the hidden cards, and the
+ * trees are combined by their visit counts.
+ *
+ * @param pn The player name.
+ * @param iterations The most iterations per move decision over all threads,
+ *        or 0 for no limit.
+ * @param millis The most time per move decision, or 0 for no limit.
+ * @param threads The number of trees to search in parallel, up to
+ *        ISMCTS_THREADS_MAX, or 0 for one per core.
+ * @param seed Seed for the bot's choices, or 0 for a random seed.
+ *
+ * @throws CaravanFatalException Neither an iteration nor a time limit is
+ *         given, or too many threads are.
+ */
+UserBotIsmcts::UserBotIsmcts(
+    PlayerName pn,
+    uint32_t iterations,
+    uint32_t millis,
+    uint32_t threads,
+    uint64_t seed) :
+    UserBot(pn),
+    rng(seed != 0 ? seed : Random::seed_from_system()),
+    max_iterations(iterations),
+    max_millis(millis),
+    num_threads(threads) {
+
+    if (max_iterations == 0 and max_millis == 0) {
+        throw CaravanFatalException(
+            "The bot must have an iteration or time limit.");
+    }
+
+    if (num_threads > ISMCTS_THREADS_MAX) {
+        throw CaravanFatalException(
+            "The bot cannot use more than " +
+            std::to_string(ISMCTS_THREADS_MAX) + " threads.");
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::clamp(
+            std::thread::hardware_concurrency(), 1u, ISMCTS_THREADS_MAX);
+    }
+}
+
+/**
+ * Joins the pondering threads and frees the trees of a bot that was not
+ * closed.
+ */
+UserBotIsmcts::~UserBotIsmcts() {
+    stop_pondering();
+    delete_trees();
+}
+
+void UserBotIsmcts::close() {
+    if (!closed) {
+        stop_pondering();
+        delete_trees();
+        closed = true;
+    }
+}
+
+GameCommand UserBotIsmcts::request_command(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    IsmctsShared shared;
+    std::vector<std::thread> workers;
+    GameCommandList moves;
+    uint8_t i_best = 0;
+    uint32_t visits_best = 0;
+    uint32_t visits_kept = 0;
+
+    ponder_stop();
+    game->legal_moves(name, &moves);
+
+    if (moves.size == 0) { return BOT_DISCARD_FIRST; }
+
+    if (has_last) {
+        reuse_trees(game);
+    } else {
+        delete_trees();
+
+        for (uint32_t i = 0; i < num_threads; ++i) {
+            trees.push_back(new IsmctsNode());
+        }
+    }
+
+    // Visits kept from pondering count towards the budget, so that the bot
+    // answers sooner at the same strength
+    if (pondered) {
+        for (IsmctsNode *tree: trees) {
+            visits_kept += tree->visits;
+        }
+    }
+
+    shared.root = game->clone();
+    shared.me = name;
+    shared.max_iterations = max_iterations - std::min(max_iterations, visits_kept);
+    shared.use_deadline = max_millis > 0;
+    shared.deadline = Clock::now() + std::chrono::milliseconds(max_millis);
+
+    if (moves.size > 1 and (max_iterations == 0 or shared.max_iterations > 0)) {
+        for (IsmctsNode *tree: trees) {
+            workers.emplace_back(run_iterations, &shared, tree, rng.next());
+        }
+
+        for (std::thread &w: workers) {
+            w.join();
+        }
+    }
+
+    // Pick the legal move that was visited most over all trees
+    for (uint8_t i = 0; i < moves.size; ++i) {
+        uint32_t visits = 0;
+
+        for (IsmctsNode *tree: trees) {
+            IsmctsNode *child = find_child(tree, &moves.commands[i]);
+            visits += child != nullptr ? child->visits : 0;
+        }
+
+        if (visits > visits_best) {
+            i_best = i;
+            visits_best = visits;
+        }
+    }
+
+    last_state = shared.root;
+    last_move = moves.commands[i_best];
+    has_last = true;
+    pondered = false;
+
+    return last_move;
+}
+
+/**
+ * Search the opponent's likely replies on the bot's own threads until the
+ * bot is next asked for a command, starting from the trees kept from the
+ * bot's last move. The game is copied, so it can change while the bot
+ * ponders.
+ *
+ * @param game The game, on the opponent's turn just after the bot's move.
+ *
+ * @throws CaravanFatalException Bot is closed.
+ */
+void UserBotIsmcts::ponder_start(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    ponder_stop();
+
+    if (!has_last or pondered or
+        game->player_turn() == name or
+        game->get_winner() != NO_PLAYER) {
+        return;
+    }
+
+    follow_own_move(game);
+
+    ponder_shared = new IsmctsShared();
+    ponder_shared->root = last_state;
+    ponder_shared->me = name;
+    ponder_shared->max_iterations = ponder_iterations;
+    ponder_shared->use_deadline = false;
+
+    for (IsmctsNode *tree: trees) {
+        ponder_workers.emplace_back(run_iterations, ponder_shared, tree, rng.next());
+    }
+}
+
+/**
+ * @throws CaravanFatalException Bot is closed.
+ */
+void UserBotIsmcts::ponder_stop() {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    stop_pondering();
+}
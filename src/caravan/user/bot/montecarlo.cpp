@@ -0,0 +1,202 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "caravan/user/bot/montecarlo.h"
+#include "caravan/user/bot/normal.h"
+#include "caravan/user/bot/playout.h"
+
+/*
+ * PRIVATE
+ */
+
+typedef std::chrono::steady_clock Clock;
+
+typedef struct PlayoutShared {
+    GameState root;
+    GameCommandList moves;
+    PlayerName me;
+    uint32_t max_playouts;
+    Clock::time_point deadline;
+    bool use_deadline;
+    bool normal_playouts;
+
+    std::atomic<uint32_t> next_playout{0};
+    std::mutex mutex;
+    std::vector<uint32_t> points;  // 2 for a win, 1 for a draw
+    std::vector<uint32_t> plays;
+} PlayoutShared;
+
+/**
+ * Play out each legal move in turn, in a fresh determinization every time,
+ * until the playout or time budget is spent.
+ */
+static void run_playouts(PlayoutShared *shared, uint64_t seed) {
+    Random rng(seed);
+    Game game{&shared->root};
+    UserBotNormal bot_abc{PLAYER_ABC};
+    UserBotNormal bot_def{PLAYER_DEF};
+    std::vector<uint32_t> points(shared->moves.size, 0);
+    std::vector<uint32_t> plays(shared->moves.size, 0);
+
+    for (uint32_t i_playout = shared->next_playout.fetch_add(1);
+         (shared->max_playouts == 0 or i_playout < shared->max_playouts) and
+         (!shared->use_deadline or Clock::now() < shared->deadline);
+         i_playout = shared->next_playout.fetch_add(1)) {
+
+        uint8_t i_move = i_playout % shared->moves.size;
+        GameCommand command = shared->moves.commands[i_move];
+        PlayerName winner;
+
+        game.restore(&shared->root);
+        game.determinize(shared->me, &rng);
+        game.play_option(&command);
+
+        if (shared->normal_playouts) {
+            winner = playout(&game, &rng, &bot_abc, &bot_def);
+        } else {
+            winner = playout(&game, &rng, nullptr, nullptr);
+        }
+
+        plays[i_move] += 1;
+        points[i_move] += winner == shared->me ? 2 : (winner == NO_PLAYER ? 1 : 0);
+    }
+
+    bot_abc.close();
+    bot_def.close();
+    game.close();
+
+    std::lock_guard<std::mutex> lock(shared->mutex);
+
+    for (uint8_t i = 0; i < shared->moves.size; ++i) {
+        shared->points[i] += points[i];
+        shared->plays[i] += plays[i];
+    }
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * A bot that plays out every legal move many times against random hidden
+ * cards and picks the move that wins most often.
+ *
+ * @param pn The player name.
+ * @param playouts The most playouts per move decision, or 0 for no limit.
+ * @param millis The most time per move decision, or 0 for no limit.
+ * @param threads The number of threads to play out on, up to
+ *        MONTECARLO_THREADS_MAX, or 0 for one per core.
+ * @param normal If true, playouts use the normal bot's moves. Otherwise,
+ *        they use random legal moves.
+ * @param seed Seed for the bot's choices, or 0 for a random seed.
+ *
+ * @throws CaravanFatalException Neither a playout nor a time limit is given,
+ *         or too many threads are.
+ */
+UserBotMonteCarlo::UserBotMonteCarlo(
+    PlayerName pn,
+    uint32_t playouts,
+    uint32_t millis,
+    uint32_t threads,
+    bool normal,
+    uint64_t seed) :
+    UserBot(pn),
+    rng(seed != 0 ? seed : Random::seed_from_system()),
+    max_playouts(playouts),
+    max_millis(millis),
+    num_threads(threads),
+    normal_playouts(normal) {
+
+    if (max_playouts == 0 and max_millis == 0) {
+        throw CaravanFatalException(
+            "The bot must have a playout or time limit.");
+    }
+
+    if (num_threads > MONTECARLO_THREADS_MAX) {
+        throw CaravanFatalException(
+            "The bot cannot use more than " +
+            std::to_string(MONTECARLO_THREADS_MAX) + " threads.");
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::clamp(
+            std::thread::hardware_concurrency(), 1u, MONTECARLO_THREADS_MAX);
+    }
+}
+
+void UserBotMonteCarlo::close() {
+    if (!closed) {
+        closed = true;
+    }
+}
+
+GameCommand UserBotMonteCarlo::request_command(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    PlayoutShared shared;
+    std::vector<std::thread> workers;
+    uint8_t i_best = 0;
+    double rate_best = -1;
+
+    last_playouts = 0;
+    game->legal_moves(name, &shared.moves);
+
+    if (shared.moves.size == 0) { return BOT_DISCARD_FIRST; }
+
+    if (shared.moves.size == 1) {
+        return shared.moves.commands[0];
+    }
+
+    // Playouts cannot tell a win now from a position that is won anyway
+    for (uint8_t i = 0; i < shared.moves.size; ++i) {
+        GameUndo undo;
+        PlayerName winner;
+
+        game->play_option(&shared.moves.commands[i], &undo);
+        winner = game->get_winner();
+        game->unplay(&undo);
+
+        if (winner == name) {
+            return shared.moves.commands[i];
+        }
+    }
+
+    shared.root = game->clone();
+    shared.me = name;
+    shared.max_playouts = max_playouts;
+    shared.use_deadline = max_millis > 0;
+    shared.deadline = Clock::now() + std::chrono::milliseconds(max_millis);
+    shared.normal_playouts = normal_playouts;
+    shared.points.assign(shared.moves.size, 0);
+    shared.plays.assign(shared.moves.size, 0);
+
+    for (uint32_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back(run_playouts, &shared, rng.next());
+    }
+
+    for (std::thread &w: workers) {
+        w.join();
+    }
+
+    for (uint8_t i = 0; i < shared.moves.size; ++i) {
+        last_playouts += shared.plays[i];
+
+        if (shared.plays[i] > 0) {
+            double rate = (double) shared.points[i] / shared.plays[i];
+
+            if (rate > rate_best) {
+                i_best = i;
+                rate_best = rate;
+            }
+        }
+    }
+
+    return shared.moves.commands[i_best];
+}
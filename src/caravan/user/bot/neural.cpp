@@ -0,0 +1,581 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "caravan/user/bot/neural.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CARAVAN_NEURAL_X86
+#include <immintrin.h>
+#endif
+
+const uint32_t NEURAL_FILE_MAGIC = 0x314E4E43;  // "CNN1"
+
+/*
+ * PRIVATE
+ */
+
+// Each kernel computes out = in * weights + biases, then optionally applies
+// ReLU. Weights are stored as a row per input so that the kernels scale rows
+// rather than take dot products: only the inputs that are not zero, given as
+// parallel index and value lists, are visited, and no horizontal sums are
+// needed. The outputs are worked through in blocks small enough to be summed
+// in registers.
+
+typedef struct NeuralInputs {
+    std::array<uint32_t, NEURAL_WIDTH_MAX> index;
+    std::array<float, NEURAL_WIDTH_MAX> value;
+    uint32_t size{0};
+} NeuralInputs;
+
+static_assert(FEATURES_SIZE <= NEURAL_WIDTH_MAX);
+
+static void gather_scalar(const float *in, uint32_t size, NeuralInputs *inputs) {
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < size; ++i) {
+        if (in[i] != 0) {
+            inputs->index[n] = i;
+            inputs->value[n] = in[i];
+            n += 1;
+        }
+    }
+
+    inputs->size = n;
+}
+
+static void layer_scalar(const NeuralLayer *l, const NeuralInputs *inputs, float *out, bool relu) {
+    for (uint32_t j = 0; j < l->stride; ++j) {
+        out[j] = l->biases[j];
+    }
+
+    for (uint32_t k = 0; k < inputs->size; ++k) {
+        const float *row = l->weights.data() + inputs->index[k] * l->stride;
+        float a = inputs->value[k];
+
+        for (uint32_t j = 0; j < l->stride; ++j) {
+            out[j] += a * row[j];
+        }
+    }
+
+    if (relu) {
+        for (uint32_t j = 0; j < l->stride; ++j) {
+            out[j] = std::max(0.0f, out[j]);
+        }
+    }
+}
+
+#ifdef CARAVAN_NEURAL_X86
+
+// Compares a register of inputs with zero at a time, then visits only the
+// bits that are set
+__attribute__((target("sse2")))
+static void gather_sse(const float *in, uint32_t size, NeuralInputs *inputs) {
+    __m128 zero = _mm_setzero_ps();
+    uint32_t i = 0;
+    uint32_t n = 0;
+
+    for (; i + 4 <= size; i += 4) {
+        uint32_t mask = ~_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(in + i), zero)) & 0xF;
+
+        for (; mask != 0; mask &= mask - 1) {
+            uint32_t at = i + __builtin_ctz(mask);
+
+            inputs->index[n] = at;
+            inputs->value[n] = in[at];
+            n += 1;
+        }
+    }
+
+    for (; i < size; ++i) {
+        if (in[i] != 0) {
+            inputs->index[n] = i;
+            inputs->value[n] = in[i];
+            n += 1;
+        }
+    }
+
+    inputs->size = n;
+}
+
+__attribute__((target("sse2")))
+static void layer_sse(const NeuralLayer *l, const NeuralInputs *inputs, float *out, bool relu) {
+    const float *w = l->weights.data();
+    const float *b = l->biases.data();
+    __m128 zero = _mm_setzero_ps();
+
+    // Blocks of four registers, or two at the end as the stride is a
+    // multiple of eight floats
+    for (uint32_t j = 0; j < l->stride; j += 16) {
+        bool half = j + 16 > l->stride;
+        __m128 y0 = _mm_loadu_ps(b + j);
+        __m128 y1 = _mm_loadu_ps(b + j + 4);
+        __m128 y2 = half ? zero : _mm_loadu_ps(b + j + 8);
+        __m128 y3 = half ? zero : _mm_loadu_ps(b + j + 12);
+
+        for (uint32_t k = 0; k < inputs->size; ++k) {
+            const float *row = w + inputs->index[k] * l->stride + j;
+            __m128 a = _mm_set1_ps(inputs->value[k]);
+
+            y0 = _mm_add_ps(y0, _mm_mul_ps(a, _mm_loadu_ps(row)));
+            y1 = _mm_add_ps(y1, _mm_mul_ps(a, _mm_loadu_ps(row + 4)));
+
+            if (!half) {
+                y2 = _mm_add_ps(y2, _mm_mul_ps(a, _mm_loadu_ps(row + 8)));
+                y3 = _mm_add_ps(y3, _mm_mul_ps(a, _mm_loadu_ps(row + 12)));
+            }
+        }
+
+        if (relu) {
+            y0 = _mm_max_ps(zero, y0);
+            y1 = _mm_max_ps(zero, y1);
+            y2 = _mm_max_ps(zero, y2);
+            y3 = _mm_max_ps(zero, y3);
+        }
+
+        _mm_storeu_ps(out + j, y0);
+        _mm_storeu_ps(out + j + 4, y1);
+
+        if (!half) {
+            _mm_storeu_ps(out + j + 8, y2);
+            _mm_storeu_ps(out + j + 12, y3);
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void gather_avx2(const float *in, uint32_t size, NeuralInputs *inputs) {
+    __m256 zero = _mm256_setzero_ps();
+    uint32_t i = 0;
+    uint32_t n = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps(in + i), zero, _CMP_EQ_OQ);
+        uint32_t mask = ~_mm256_movemask_ps(eq) & 0xFF;
+
+        for (; mask != 0; mask &= mask - 1) {
+            uint32_t at = i + __builtin_ctz(mask);
+
+            inputs->index[n] = at;
+            inputs->value[n] = in[at];
+            n += 1;
+        }
+    }
+
+    for (; i < size; ++i) {
+        if (in[i] != 0) {
+            inputs->index[n] = i;
+            inputs->value[n] = in[i];
+            n += 1;
+        }
+    }
+
+    inputs->size = n;
+}
+
+__attribute__((target("avx2,fma")))
+static void layer_avx2(const NeuralLayer *l, const NeuralInputs *inputs, float *out, bool relu) {
+    const float *w = l->weights.data();
+    const float *b = l->biases.data();
+    __m256 zero = _mm256_setzero_ps();
+    uint32_t j = 0;
+
+    // Blocks of four registers, then of one
+    for (; j + 32 <= l->stride; j += 32) {
+        __m256 y0 = _mm256_loadu_ps(b + j);
+        __m256 y1 = _mm256_loadu_ps(b + j + 8);
+        __m256 y2 = _mm256_loadu_ps(b + j + 16);
+        __m256 y3 = _mm256_loadu_ps(b + j + 24);
+
+        for (uint32_t k = 0; k < inputs->size; ++k) {
+            const float *row = w + inputs->index[k] * l->stride + j;
+            __m256 a = _mm256_set1_ps(inputs->value[k]);
+
+            y0 = _mm256_fmadd_ps(a, _mm256_loadu_ps(row), y0);
+            y1 = _mm256_fmadd_ps(a, _mm256_loadu_ps(row + 8), y1);
+            y2 = _mm256_fmadd_ps(a, _mm256_loadu_ps(row + 16), y2);
+            y3 = _mm256_fmadd_ps(a, _mm256_loadu_ps(row + 24), y3);
+        }
+
+        if (relu) {
+            y0 = _mm256_max_ps(zero, y0);
+            y1 = _mm256_max_ps(zero, y1);
+            y2 = _mm256_max_ps(zero, y2);
+            y3 = _mm256_max_ps(zero, y3);
+        }
+
+        _mm256_storeu_ps(out + j, y0);
+        _mm256_storeu_ps(out + j + 8, y1);
+        _mm256_storeu_ps(out + j + 16, y2);
+        _mm256_storeu_ps(out + j + 24, y3);
+    }
+
+    for (; j < l->stride; j += 8) {
+        __m256 y = _mm256_loadu_ps(b + j);
+
+        for (uint32_t k = 0; k < inputs->size; ++k) {
+            const float *row = w + inputs->index[k] * l->stride + j;
+            y = _mm256_fmadd_ps(_mm256_set1_ps(inputs->value[k]), _mm256_loadu_ps(row), y);
+        }
+
+        _mm256_storeu_ps(out + j, relu ? _mm256_max_ps(zero, y) : y);
+    }
+}
+
+#endif
+
+static NeuralKernel best_kernel() {
+    if (NeuralNet::supports(NEURAL_AVX2)) { return NEURAL_AVX2; }
+    if (NeuralNet::supports(NEURAL_SSE)) { return NEURAL_SSE; }
+    return NEURAL_SCALAR;
+}
+
+static void read_or_fail(std::ifstream *in, void *data, size_t size, std::string path) {
+    in->read((char *) data, size);
+
+    if (!(*in)) {
+        throw CaravanFatalException(
+            "The weights file '" + path + "' is not valid.");
+    }
+}
+
+/**
+ * Each weights file is read once and shared by the bots that use it, until
+ * the last of them is closed. After that the file is read again, so new bots
+ * pick up a network retrained at the same path.
+ *
+ * @throws CaravanFatalException The file cannot be read or is not valid.
+ */
+static std::shared_ptr<const NeuralNet> load_net(std::string path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<const NeuralNet>> loaded;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const NeuralNet> net = loaded[path].lock();
+
+    if (net) {
+        return net;
+    }
+
+    net = std::shared_ptr<const NeuralNet>(
+        new NeuralNet(path),
+        [](NeuralNet *n) { n->close(); delete n; });
+
+    loaded[path] = net;
+
+    return net;
+}
+
+void NeuralNet::add_layer(uint32_t size_in, uint32_t size_out) {
+    NeuralLayer layer;
+
+    if (size_out == 0 or size_out > NEURAL_WIDTH_MAX) {
+        throw CaravanFatalException(
+            "A layer must have between 1 and " +
+            std::to_string(NEURAL_WIDTH_MAX) + " outputs (inclusive).");
+    }
+
+    layer.size_in = size_in;
+    layer.size_out = size_out;
+    layer.stride = (size_out + NEURAL_LANES - 1) / NEURAL_LANES * NEURAL_LANES;
+    layer.weights.assign(size_in * layer.stride, 0);
+    layer.biases.assign(layer.stride, 0);
+
+    layers.push_back(std::move(layer));
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * Load a network from a weights file, in native byte order, which holds:
+ * the magic "CNN1", the number of features, the number of layers, the
+ * outputs of each layer, then each layer's weights (a row of inputs per
+ * output) followed by its biases, all as 32-bit floats.
+ *
+ * @param path The weights file.
+ *
+ * @throws CaravanFatalException The file cannot be read or is not valid.
+ */
+NeuralNet::NeuralNet(std::string path) : kernel(best_kernel()), closed(false) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0;
+    uint32_t features = 0;
+    uint32_t num_layers = 0;
+    std::vector<uint32_t> sizes;
+
+    if (!in) {
+        throw CaravanFatalException(
+            "Could not open the weights file '" + path + "'.");
+    }
+
+    read_or_fail(&in, &magic, sizeof(magic), path);
+    read_or_fail(&in, &features, sizeof(features), path);
+    read_or_fail(&in, &num_layers, sizeof(num_layers), path);
+
+    if (magic != NEURAL_FILE_MAGIC or features != FEATURES_SIZE or
+        num_layers == 0 or num_layers > NEURAL_LAYERS_MAX) {
+        throw CaravanFatalException(
+            "The weights file '" + path + "' is not valid.");
+    }
+
+    sizes.resize(num_layers);
+    read_or_fail(&in, sizes.data(), num_layers * sizeof(uint32_t), path);
+
+    if (sizes.back() != 1) {
+        throw CaravanFatalException(
+            "The weights file '" + path + "' must end in a single output.");
+    }
+
+    for (uint32_t i = 0; i < num_layers; ++i) {
+        add_layer(i == 0 ? FEATURES_SIZE : sizes[i - 1], sizes[i]);
+    }
+
+    for (NeuralLayer &l: layers) {
+        std::vector<float> row(l.size_in);
+
+        // Transpose each output's row into the per-input layout
+        for (uint32_t j = 0; j < l.size_out; ++j) {
+            read_or_fail(&in, row.data(), l.size_in * sizeof(float), path);
+
+            for (uint32_t i = 0; i < l.size_in; ++i) {
+                l.weights[i * l.stride + j] = row[i];
+            }
+        }
+
+        read_or_fail(&in, l.biases.data(), l.size_out * sizeof(float), path);
+    }
+}
+
+/**
+ * A network with random weights, for testing and as a starting point for
+ * training.
+ *
+ * @param sizes_hidden The outputs of each hidden layer.
+ * @param seed Seed for the weights.
+ *
+ * @throws CaravanFatalException A layer is empty or too wide.
+ */
+NeuralNet::NeuralNet(std::vector<uint32_t> sizes_hidden, uint64_t seed) :
+    kernel(best_kernel()), closed(false) {
+    Random rng{seed};
+    uint32_t size_in = FEATURES_SIZE;
+
+    sizes_hidden.push_back(1);
+
+    for (uint32_t size_out: sizes_hidden) {
+        add_layer(size_in, size_out);
+        size_in = size_out;
+    }
+
+    // He initialisation suits the ReLU layers
+    for (NeuralLayer &l: layers) {
+        float limit = std::sqrt(6.0f / l.size_in);
+
+        for (uint32_t i = 0; i < l.size_in; ++i) {
+            for (uint32_t j = 0; j < l.size_out; ++j) {
+                l.weights[i * l.stride + j] = (float) ((rng.unit() * 2 - 1) * limit);
+            }
+        }
+    }
+}
+
+void NeuralNet::close() {
+    if (!closed) {
+        layers.clear();
+        closed = true;
+    }
+}
+
+/**
+ * Evaluate the network with the fastest kernel that the processor supports,
+ * unless another has been set. It can be called from many threads at once.
+ *
+ * @param features A player's view, from encode_features.
+ * @return The value of the view for the player, from -1 to 1.
+ *
+ * @throws CaravanFatalException Network is closed.
+ */
+float NeuralNet::evaluate(const Features *features) const {
+    if (closed) { throw CaravanFatalException("Network is closed."); }
+
+    alignas(32) float buf_a[NEURAL_WIDTH_MAX];
+    alignas(32) float buf_b[NEURAL_WIDTH_MAX];
+    const float *in = features->data();
+    float *out = buf_a;
+    NeuralInputs inputs;
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        bool relu = i + 1 < layers.size();
+
+        switch (kernel) {
+#ifdef CARAVAN_NEURAL_X86
+            case NEURAL_AVX2:
+                gather_avx2(in, layers[i].size_in, &inputs);
+                layer_avx2(&layers[i], &inputs, out, relu);
+                break;
+            case NEURAL_SSE:
+                gather_sse(in, layers[i].size_in, &inputs);
+                layer_sse(&layers[i], &inputs, out, relu);
+                break;
+#endif
+            default:
+                gather_scalar(in, layers[i].size_in, &inputs);
+                layer_scalar(&layers[i], &inputs, out, relu);
+        }
+
+        in = out;
+        out = out == buf_a ? buf_b : buf_a;
+    }
+
+    return std::tanh(in[0]);
+}
+
+NeuralKernel NeuralNet::get_kernel() {
+    if (closed) { throw CaravanFatalException("Network is closed."); }
+
+    return kernel;
+}
+
+/**
+ * @param k The kernel to evaluate with.
+ *
+ * @throws CaravanFatalException The processor does not support the kernel.
+ * @throws CaravanFatalException Network is closed.
+ */
+void NeuralNet::set_kernel(NeuralKernel k) {
+    if (closed) { throw CaravanFatalException("Network is closed."); }
+
+    if (!supports(k)) {
+        throw CaravanFatalException(
+            "The processor does not support the kernel.");
+    }
+
+    kernel = k;
+}
+
+/**
+ * @param path The weights file to write, in the format that the network
+ *        loads from.
+ *
+ * @throws CaravanFatalException The file cannot be written.
+ * @throws CaravanFatalException Network is closed.
+ */
+void NeuralNet::save(std::string path) {
+    if (closed) { throw CaravanFatalException("Network is closed."); }
+
+    std::ofstream out(path, std::ios::binary);
+    uint32_t features = FEATURES_SIZE;
+    uint32_t num_layers = layers.size();
+
+    out.write((char *) &NEURAL_FILE_MAGIC, sizeof(NEURAL_FILE_MAGIC));
+    out.write((char *) &features, sizeof(features));
+    out.write((char *) &num_layers, sizeof(num_layers));
+
+    for (NeuralLayer &l: layers) {
+        out.write((char *) &l.size_out, sizeof(l.size_out));
+    }
+
+    for (NeuralLayer &l: layers) {
+        for (uint32_t j = 0; j < l.size_out; ++j) {
+            for (uint32_t i = 0; i < l.size_in; ++i) {
+                out.write((char *) &l.weights[i * l.stride + j], sizeof(float));
+            }
+        }
+
+        out.write((char *) l.biases.data(), l.size_out * sizeof(float));
+    }
+
+    if (!out) {
+        throw CaravanFatalException(
+            "Could not write the weights file '" + path + "'.");
+    }
+}
+
+/**
+ * @param k A kernel.
+ * @return Whether the processor, and this build, can evaluate with it.
+ */
+bool NeuralNet::supports(NeuralKernel k) {
+    switch (k) {
+        case NEURAL_SCALAR:
+            return true;
+#ifdef CARAVAN_NEURAL_X86
+        case NEURAL_SSE:
+            return __builtin_cpu_supports("sse2");
+        case NEURAL_AVX2:
+            return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma");
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * A bot that plays each legal move, scores the resulting view with a
+ * neural network, and picks the best. Bots that use the same file at the
+ * same time share one copy of the network.
+ *
+ * @param pn The bot's player name.
+ * @param path The weights file.
+ *
+ * @throws CaravanFatalException The weights file cannot be read or is not
+ *         valid.
+ */
+UserBotNeural::UserBotNeural(PlayerName pn, std::string path) :
+    UserBot(pn),
+    net(load_net(path)) {}
+
+void UserBotNeural::close() {
+    if (!closed) {
+        net.reset();
+        closed = true;
+    }
+}
+
+GameCommand UserBotNeural::request_command(Game *game) {
+    if (closed) { throw CaravanFatalException("Bot is closed."); }
+
+    GameCommandList moves;
+    Features features;
+    GameUndo undo;
+    float value_best = -2;
+    uint8_t i_best = 0;
+
+    game->legal_moves(name, &moves);
+
+    if (moves.size == 0) { return BOT_DISCARD_FIRST; }
+
+    for (uint8_t i = 0; i < moves.size; ++i) {
+        float value;
+
+        game->play_option(&moves.commands[i], &undo);
+
+        if (game->get_winner() != NO_PLAYER) {
+            value = game->get_winner() == name ? 2 : -2;
+
+        } else {
+            encode_features(game, name, &features);
+            value = net->evaluate(&features);
+        }
+
+        game->unplay(&undo);
+
+        if (value > value_best) {
+            value_best = value;
+            i_best = i;
+        }
+
+        if (value_best == 2) { break; }
+    }
+
+    return moves.commands[i_best];
+}
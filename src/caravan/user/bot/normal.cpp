@@ -9,12 +9,9 @@
  * PRIVATE
  */
 
-const std::string PLAY = "P";
-const std::string CLEAR = "C";
-
 uint8_t pos_card_numeral(Player *p) {
-    uint8_t size_hand = p->get_size_hand();
-    Hand h = p->get_hand();
+    uint8_t size_hand = p->size_hand();
+    Hand h = p->hand();
 
     for (int i = 0; i < size_hand; ++i) {
         if (is_numeral_card(h[i])) {
@@ -29,13 +26,13 @@ uint8_t pos_card_numeral(Player *p) {
  * PROTECTED
  */
 
-std::string UserBotNormal::generate_move(
+GameCommand UserBotNormal::generate_move(
     Game *game,
     bool allow_numeral,
     bool allow_face,
     bool allow_clear) {
-    Player *me = game->get_player(name);
-    uint8_t my_hand_size = me->get_size_hand();
+    Player *me = game->player(name);
+    uint8_t my_hand_size = me->size_hand();
 
     if (my_hand_size == 0) {
         throw CaravanFatalException("Bot has an empty hand.");
@@ -45,7 +42,7 @@ std::string UserBotNormal::generate_move(
     PlayerCaravanNames opp_cvns = game->get_player_caravan_names(
         name == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC);
 
-    uint16_t my_move_count = me->get_moves_count();
+    uint16_t my_move_count = me->moves_count();
 
     if (my_move_count < MOVES_START_ROUND) {
         // Add numeral cards for start round
@@ -56,22 +53,20 @@ std::string UserBotNormal::generate_move(
                 "to finish the start phase.");
         }
 
-        return PLAY +
-               std::to_string(pos_hand) +
-               caravan_letter(my_cvns[my_move_count]);
+        return {OPTION_PLAY, pos_hand, my_cvns[my_move_count]};
 
     } else {
         // After start round
-        Table *table = game->get_table();
+        Table *table = game->table();
 
         // Clear any caravans that are bust or full of cards
         if(allow_clear) {
             for (uint8_t i_cvn = 0; i_cvn < PLAYER_CARAVANS_MAX; i_cvn++) {
-                Caravan *cvn = table->get_caravan(my_cvns[i_cvn]);
+                Caravan *cvn = table->caravan(my_cvns[i_cvn]);
 
-                if (cvn->get_bid() > CARAVAN_SOLD_MAX ||
-                    cvn->get_size() == TRACK_NUMERIC_MAX) {
-                    return CLEAR + caravan_letter(my_cvns[i_cvn]);
+                if (cvn->bid() > CARAVAN_SOLD_MAX ||
+                    cvn->size() == TRACK_NUMERIC_MAX) {
+                    return {OPTION_CLEAR, 0, my_cvns[i_cvn]};
                 }
             }
         }
@@ -83,16 +78,14 @@ std::string UserBotNormal::generate_move(
             if (is_numeral_card(c_hand) && allow_numeral) {
                 // If numeral, look through caravans
                 for (uint8_t i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
-                    Caravan *my_cvn = table->get_caravan(my_cvns[i]);
-                    Caravan *opp_cvn = table->get_caravan(opp_cvns[i]);
+                    Caravan *my_cvn = table->caravan(my_cvns[i]);
+                    Caravan *opp_cvn = table->caravan(opp_cvns[i]);
 
-                    std::string move_draft =
-                        PLAY +
-                        std::to_string(pos_hand) +
-                        caravan_letter(my_cvn->get_name());
+                    GameCommand move_draft = {
+                        OPTION_PLAY, pos_hand, my_cvn->get_name()};
 
-                    uint16_t my_cvn_bid = my_cvn->get_bid();
-                    uint16_t opp_cvn_bid = opp_cvn->get_bid();
+                    uint16_t my_cvn_bid = my_cvn->bid();
+                    uint16_t opp_cvn_bid = opp_cvn->bid();
 
                     // Skip caravan if sold and winning
                     if (my_cvn_bid >= CARAVAN_SOLD_MIN &&
@@ -102,7 +95,7 @@ std::string UserBotNormal::generate_move(
                         continue;
                     }
 
-                    uint8_t my_cvn_size = my_cvn->get_size();
+                    uint8_t my_cvn_size = my_cvn->size();
 
                     // Skip caravan if full
                     if (my_cvn_size == TRACK_NUMERIC_MAX) {
@@ -115,7 +108,7 @@ std::string UserBotNormal::generate_move(
                     }
 
                     // Not empty, so check the top slot in the caravan
-                    Slot slot_top = my_cvn->get_slot(my_cvn_size);
+                    Slot slot_top = my_cvn->slot(my_cvn_size);
 
                     // Ignore numeral if cards have same rank
                     if (slot_top.card.rank == c_hand.rank) {
@@ -124,15 +117,15 @@ std::string UserBotNormal::generate_move(
 
                     bool not_bust =
                         (my_cvn_bid +
-                         numeral_rank_value(c_hand)) <= CARAVAN_SOLD_MAX;
+                         card_value(c_hand)) <= CARAVAN_SOLD_MAX;
 
                     // Same suit as caravan and numeral would not cause bust
-                    if (my_cvn->get_suit() == c_hand.suit && not_bust) {
+                    if (my_cvn->suit() == c_hand.suit && not_bust) {
                         return move_draft;
                     }
 
                     // Not same suit, check direction
-                    Direction my_cvn_dir = my_cvn->get_direction();
+                    Direction my_cvn_dir = my_cvn->direction();
 
                     // Card ascending with caravan and would not bust
                     if (my_cvn_dir == ASCENDING &&
@@ -156,7 +149,7 @@ std::string UserBotNormal::generate_move(
                 // Put face card on opp caravan with the most cards
                 for (uint8_t i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
                     uint8_t size_cvn =
-                        table->get_caravan(opp_cvns[i])->get_size();
+                        table->caravan(opp_cvns[i])->size();
 
                     if (size_cvn > n_opp_cvn_most_cards) {
                         i_opp_cvn_most_cards = i;
@@ -168,17 +161,14 @@ std::string UserBotNormal::generate_move(
                 if (i_opp_cvn_most_cards < PLAYER_CARAVANS_MAX &&
                     n_opp_cvn_most_cards > 0) {
 
-                    Caravan *opp_cvn = table->get_caravan(
+                    Caravan *opp_cvn = table->caravan(
                         opp_cvns[i_opp_cvn_most_cards]);
 
-                    uint8_t opp_cvn_size = opp_cvn->get_size();
-                    Slot opp_slot_top = opp_cvn->get_slot(opp_cvn_size);
+                    uint8_t opp_cvn_size = opp_cvn->size();
+                    Slot opp_slot_top = opp_cvn->slot(opp_cvn_size);
 
-                    std::string move_draft =
-                        PLAY +
-                        std::to_string(pos_hand) +
-                        caravan_letter(opp_cvn->get_name()) +
-                        std::to_string(opp_cvn->get_size());
+                    GameCommand move_draft = {
+                        OPTION_PLAY, pos_hand, opp_cvn->get_name(), opp_cvn_size};
 
                     if (opp_slot_top.i_faces < TRACK_FACE_MAX) {
                         return move_draft;
@@ -188,7 +178,7 @@ std::string UserBotNormal::generate_move(
         }
     }
 
-    return "";
+    return {};
 }
 
 /*
@@ -201,14 +191,14 @@ void UserBotNormal::close() {
     }
 }
 
-std::string UserBotNormal::request_move(Game *game) {
+GameCommand UserBotNormal::request_command(Game *game) {
     if (closed) { throw CaravanFatalException("Bot is closed."); }
 
-    std::string move = generate_move(game, true, true, true);
+    GameCommand move = generate_move(game, true, true, true);
 
     // Return move if able to generate one
-    if(!move.empty()) { return move; }
+    if(move.option != NO_OPTION) { return move; }
 
     // If no useful move could be made, discard first card in hand
-    return "D1";
+    return BOT_DISCARD_FIRST;
 }
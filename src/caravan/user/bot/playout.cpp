@@ -0,0 +1,67 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "caravan/user/bot/playout.h"
+
+/**
+ * Play a game to its end, as used by search bots to estimate how good a
+ * position is.
+ *
+ * @param game The game to play, which is changed by the playout.
+ * @param rng The generator used to pick random moves.
+ * @param bot_abc The bot that picks the first player's moves, or nullptr to
+ *        pick them at random.
+ * @param bot_def As above, but for the second player.
+ * @return The winner, or NO_PLAYER if nobody won within PLAYOUT_MOVES_MAX
+ *         moves. A player who has no legal move loses.
+ */
+PlayerName playout(Game *game, Random *rng, UserBot *bot_abc, UserBot *bot_def) {
+    GameCommandList moves;
+    PlayerName winner;
+
+    for (uint16_t i = 0; i < PLAYOUT_MOVES_MAX; ++i) {
+        if ((winner = game->get_winner()) != NO_PLAYER) {
+            return winner;
+        }
+
+        PlayerName pturn = game->player_turn();
+        Player *p = game->player(pturn);
+        UserBot *bot = pturn == PLAYER_ABC ? bot_abc : bot_def;
+        GameCommand command;
+
+        // Past the start round, a player with cards can always discard, so
+        // the moves are only listed when there is no bot or its command is
+        // not legal. In the start round, a bot may lack the numerals it
+        // expects, so it is only asked once the player is known to have a move.
+        moves.size = 0;
+
+        if (bot == nullptr or
+            p->moves_count() < MOVES_START_ROUND or
+            p->size_hand() == 0) {
+            game->legal_moves(pturn, &moves);
+
+            if (moves.size == 0) {
+                return pturn == PLAYER_ABC ? PLAYER_DEF : PLAYER_ABC;
+            }
+        }
+
+        if (bot != nullptr) {
+            command = bot->request_command(game);
+
+            if (game->is_legal(&command)) {
+                game->play_option(&command);
+                continue;
+            }
+
+            if (moves.size == 0) {
+                game->legal_moves(pturn, &moves);
+            }
+        }
+
+        command = moves.commands[rng->below(moves.size)];
+        game->play_option(&command);
+    }
+
+    return game->get_winner();
+}
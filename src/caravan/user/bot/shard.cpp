@@ -0,0 +1,171 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <cstdio>
+#include "caravan/user/bot/shard.h"
+
+/*
+ * PROTECTED
+ */
+
+/**
+ * Write the shard's final record count into its header, then close it.
+ *
+ * @throws CaravanFatalException The shard could not be written.
+ */
+void ShardWriter::finish_shard() {
+    out.seekp(0);
+    out.write((char *) &header, sizeof(header));
+    out.close();
+
+    if (out.fail()) {
+        throw CaravanFatalException(
+            "Could not write the shard '" + shard_path(prefix, shards - 1) + "'.");
+    }
+}
+
+/**
+ * @throws CaravanFatalException The shard could not be created.
+ */
+void ShardWriter::open_shard() {
+    std::string path = shard_path(prefix, shards);
+
+    header = {};
+    header.size_header = sizeof(ShardHeader);
+    header.size_record = sizeof(ShardRecord);
+
+    out.open(path, std::ios::binary | std::ios::trunc);
+    out.write((char *) &header, sizeof(header));
+
+    if (!out) {
+        throw CaravanFatalException(
+            "Could not create the shard '" + path + "'.");
+    }
+
+    shards += 1;
+}
+
+/*
+ * PUBLIC
+ */
+
+/**
+ * Writes records into numbered shards, starting a new shard whenever the
+ * current one is full. Shards are only created once there is a record to
+ * write.
+ *
+ * @param path_prefix Path of the shards, before their number.
+ * @param records_per_shard Most records that a shard can hold.
+ *
+ * @throws CaravanFatalException A shard must hold at least one record.
+ */
+ShardWriter::ShardWriter(std::string path_prefix, uint64_t records_per_shard) :
+    prefix(path_prefix),
+    records_max(records_per_shard),
+    header({}),
+    shards(0),
+    records(0),
+    closed(false) {
+
+    if (records_max == 0) {
+        throw CaravanFatalException(
+            "A shard must hold at least one record.");
+    }
+}
+
+/**
+ * @throws CaravanFatalException The last shard could not be written.
+ */
+void ShardWriter::close() {
+    if (!closed) {
+        closed = true;
+
+        if (out.is_open()) {
+            finish_shard();
+        }
+    }
+}
+
+uint64_t ShardWriter::get_records() {
+    if (closed) { throw CaravanFatalException("Shard writer is closed."); }
+
+    return records;
+}
+
+uint32_t ShardWriter::get_shards() {
+    if (closed) { throw CaravanFatalException("Shard writer is closed."); }
+
+    return shards;
+}
+
+/**
+ * @param path_prefix Path of the shards, before their number.
+ * @param index The shard's number, from 0.
+ * @return The path of the shard, such as "prefix-0003.shard".
+ */
+std::string ShardWriter::shard_path(std::string path_prefix, uint32_t index) {
+    char number[16];
+
+    snprintf(number, sizeof(number), "-%04u", index);
+
+    return path_prefix + number + SHARD_EXTENSION;
+}
+
+/**
+ * @param record The records to append.
+ * @param count The number of records.
+ *
+ * @throws CaravanFatalException A shard could not be created or written.
+ * @throws CaravanFatalException Shard writer is closed.
+ */
+void ShardWriter::write(const ShardRecord *record, uint64_t count) {
+    if (closed) { throw CaravanFatalException("Shard writer is closed."); }
+
+    while (count > 0) {
+        uint64_t n;
+
+        if (!out.is_open()) {
+            open_shard();
+        }
+
+        n = std::min(count, records_max - header.records);
+        out.write((char *) record, n * sizeof(ShardRecord));
+
+        if (!out) {
+            throw CaravanFatalException(
+                "Could not write the shard '" + shard_path(prefix, shards - 1) + "'.");
+        }
+
+        header.records += n;
+        records += n;
+        record += n;
+        count -= n;
+
+        if (header.records == records_max) {
+            finish_shard();
+        }
+    }
+}
+
+/*
+ * RECORDS
+ */
+
+/**
+ * Copy a played command into a record's fixed-width fields.
+ *
+ * @param command The command, as played, including the cards it logged.
+ * @param record The record to fill.
+ */
+void encode_command(GameCommand *command, ShardRecord *record) {
+    record->option = command->option;
+    record->pos_hand = command->pos_hand;
+    record->caravan_name = command->caravan_name;
+    record->pos_caravan = command->pos_caravan;
+    record->hand_rank = command->hand.rank;
+    record->hand_suit = command->hand.suit;
+    record->board_rank = command->board.rank;
+    record->board_suit = command->board.suit;
+}
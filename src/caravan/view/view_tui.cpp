@@ -45,6 +45,21 @@ const std::string NAME_PL2 = "PL2";
 const std::string NAME_BOT1 = "BOT1";
 const std::string NAME_BOT2 = "BOT2";
 
+// Indexed by suit and by rank
+constexpr std::array<const wchar_t *, SPADES + 1> SUIT_WSTR = {
+    L" ", L"♣", L"♦", L"♥", L"♠"
+};
+
+constexpr std::array<const wchar_t *, JOKER + 1> RANK_WSTR = {
+    L"A", L"2", L"3", L"4", L"5", L"6", L"7", L"8", L"9", L"10",
+    L"J", L"Q", L"K", L"JO"
+};
+
+constexpr std::array<const wchar_t *, JOKER + 1> RANK_WSTR_LEAD = {
+    L" A", L" 2", L" 3", L" 4", L" 5", L" 6", L" 7", L" 8", L" 9", L"10",
+    L" J", L" Q", L" K", L"JO"
+};
+
 uint64_t time_milliseconds() {
     using namespace std::chrono;
     return duration_cast<milliseconds>(
@@ -71,20 +86,11 @@ std::wstring caravan_to_wstr(CaravanName caravan_name, bool letter_only) {
 }
 
 std::wstring suit_to_wstr(Suit suit) {
-    switch (suit) {
-        case NO_SUIT:
-            return L" ";
-        case SPADES:
-            return L"♠";
-        case CLUBS:
-            return L"♣";
-        case HEARTS:
-            return L"♥";
-        case DIAMONDS:
-            return L"♦";
-        default:
-            throw CaravanFatalException("Invalid suit.");
+    if (suit >= SUIT_WSTR.size()) {
+        throw CaravanFatalException("Invalid suit.");
     }
+
+    return SUIT_WSTR[suit];
 }
 
 std::wstring direction_to_wstr(Direction direction) {
@@ -101,38 +107,12 @@ std::wstring direction_to_wstr(Direction direction) {
 }
 
 std::wstring rank_to_wstr(Rank rank, bool lead) {
-    switch (rank) {
-        case ACE:
-            return lead ? L" A" : L"A";
-        case TWO:
-            return lead ? L" 2" : L"2";
-        case THREE:
-            return lead ? L" 3" : L"3";
-        case FOUR:
-            return lead ? L" 4" : L"4";
-        case FIVE:
-            return lead ? L" 5" : L"5";
-        case SIX:
-            return lead ? L" 6" : L"6";
-        case SEVEN:
-            return lead ? L" 7" : L"7";
-        case EIGHT:
-            return lead ? L" 8" : L"8";
-        case NINE:
-            return lead ? L" 9" : L"9";
-        case TEN:
-            return L"10";
-        case JACK:
-            return lead ? L" J" : L"J";
-        case QUEEN:
-            return lead ? L" Q" : L"Q";
-        case KING:
-            return lead ? L" K" : L"K";
-        case JOKER:
-            return L"JO";
-        default:
-            throw CaravanFatalException("Invalid rank.");
+    if (rank >= RANK_WSTR.size()) {
+        throw CaravanFatalException("Invalid rank.");
     }
+
+    // Single characters are led by a space to line up with "10" and "JO"
+    return lead ? RANK_WSTR_LEAD[rank] : RANK_WSTR[rank];
 }
 
 std::shared_ptr<ftxui::Node> suit_to_text(ViewConfig *vc, Suit suit) {
@@ -172,202 +152,6 @@ void push_card(ViewConfig *vc, ftxui::Elements *e, Card card, bool lead) {
     }
 }
 
-void process_first(std::string input, GameCommand *command) {
-    char c = input.at(0);  // minimum input size already checked elsewhere
-
-    switch (c) {
-        case 'P':
-        case 'p':
-            command->option = OPTION_PLAY;
-            /*
-             * P2F
-             * "Play numeral card at hand pos 2 onto caravan F"
-             *
-             * P4F8
-             * "Play face card at hand pos 4 onto caravan F, slot 8"
-             */
-            break;
-
-        case 'D':
-        case 'd':
-            command->option = OPTION_DISCARD;
-            /*
-             * D3
-             * "Discard card at hand pos 3"
-             */
-            break;
-
-        case 'C':
-        case 'c':
-            /*
-             * CE
-             * "Clear caravan E"
-             */
-            command->option = OPTION_CLEAR;
-            break;
-
-        default:
-            throw CaravanInputException(
-                "Invalid option '" + std::string(1, c) + "', must be one of: (P)lay, (D)iscard, (C)lear.");
-    }
-}
-
-void process_second(std::string input, GameCommand *command) {
-    if (command->option == OPTION_PLAY or command->option == OPTION_DISCARD) {
-
-        if (input.size() < 2) {
-            throw CaravanInputException("A hand position has not been entered.");
-        }
-
-        char c = input.at(1);
-
-        switch (c) {
-            case '1':
-                command->pos_hand = 1;
-                break;
-            case '2':
-                command->pos_hand = 2;
-                break;
-            case '3':
-                command->pos_hand = 3;
-                break;
-            case '4':
-                command->pos_hand = 4;
-                break;
-            case '5':
-                command->pos_hand = 5;
-                break;
-            case '6':
-                command->pos_hand = 6;
-                break;
-            case '7':
-                command->pos_hand = 7;
-                break;
-            case '8':
-                command->pos_hand = 8;
-                break;
-            default:
-                throw CaravanInputException("Invalid hand position '" + std::string(1, c) + "'.");
-        }
-
-    } else if (command->option == OPTION_CLEAR) {
-
-        if (input.size() < 2) {
-            throw CaravanInputException("A caravan name has not been entered.");
-        }
-
-        char c = input.at(1);
-
-        switch (c) {
-            case 'A':
-            case 'a':
-                command->caravan_name = CARAVAN_A;
-                break;
-            case 'B':
-            case 'b':
-                command->caravan_name = CARAVAN_B;
-                break;
-            case 'C':
-            case 'c':
-                command->caravan_name = CARAVAN_C;
-                break;
-            case 'D':
-            case 'd':
-                command->caravan_name = CARAVAN_D;
-                break;
-            case 'E':
-            case 'e':
-                command->caravan_name = CARAVAN_E;
-                break;
-            case 'F':
-            case 'f':
-                command->caravan_name = CARAVAN_F;
-                break;
-            default:
-                throw CaravanInputException("Invalid caravan name '" + std::string(1, c) + "', must be between: A-F.");
-        }
-
-    } // else invalid command type, handled during parse of first character
-}
-
-void process_third(std::string input, GameCommand *command) {
-    if (command->option == OPTION_PLAY) {
-
-        if (input.size() < 3) {
-            throw CaravanInputException("A caravan name has not been entered.");
-        }
-
-        char c = input.at(2);
-
-        switch (c) {
-            case 'A':
-            case 'a':
-                command->caravan_name = CARAVAN_A;
-                break;
-            case 'B':
-            case 'b':
-                command->caravan_name = CARAVAN_B;
-                break;
-            case 'C':
-            case 'c':
-                command->caravan_name = CARAVAN_C;
-                break;
-            case 'D':
-            case 'd':
-                command->caravan_name = CARAVAN_D;
-                break;
-            case 'E':
-            case 'e':
-                command->caravan_name = CARAVAN_E;
-                break;
-            case 'F':
-            case 'f':
-                command->caravan_name = CARAVAN_F;
-                break;
-            default:
-                throw CaravanInputException("Invalid caravan name '" + std::string(1, c) + "', must be between: A-F.");
-        }
-    }
-}
-
-void process_fourth(std::string input, GameCommand *command) {
-    if (command->option == OPTION_PLAY) {
-
-        if (input.size() < 4) { return; }  // optional, not an error
-
-        char c = input.at(3);
-
-        switch (c) {
-            case '1':
-                command->pos_caravan = 1;
-                break;
-            case '2':
-                command->pos_caravan = 2;
-                break;
-            case '3':
-                command->pos_caravan = 3;
-                break;
-            case '4':
-                command->pos_caravan = 4;
-                break;
-            case '5':
-                command->pos_caravan = 5;
-                break;
-            case '6':
-                command->pos_caravan = 6;
-                break;
-            case '7':
-                command->pos_caravan = 7;
-                break;
-            case '8':
-                command->pos_caravan = 8;
-                break;
-            default:
-                throw CaravanInputException("Invalid caravan position '" + std::string(1, c) + "'.");
-        }
-    }
-}
-
 GameCommand ViewTUI::parse_user_input(std::string input, bool confirmed) {
     GameCommand command;
 
@@ -375,30 +159,7 @@ GameCommand ViewTUI::parse_user_input(std::string input, bool confirmed) {
     if (input.empty()) { return command; }
 
     try {
-        /*
-         * FIRST
-         * - COMMAND TYPE
-         */
-        process_first(input, &command);
-
-        /*
-         * SECOND
-         * - HAND POSITION or
-         * - CARAVAN NAME
-         */
-        process_second(input, &command);
-
-        /*
-         * THIRD
-         * - CARAVAN NAME
-         */
-        process_third(input, &command);
-
-        /*
-         * FOURTH
-         * - CARAVAN POSITION (used when selecting Face card only)
-         */
-        process_fourth(input, &command);
+        parse_command(input, &command);
 
     } catch(CaravanInputException &e) {
         if(confirmed) {
@@ -667,6 +428,46 @@ std::shared_ptr<ftxui::Node> gen_deck(ViewConfig *vc, Game *game, bool top) {
     ) | size(WIDTH, EQUAL, WIDTH_DECK);
 }
 
+/**
+ * Generate a caravan only if the game or the caravan's highlight has changed
+ * since it was last generated, otherwise reuse it.
+ */
+std::shared_ptr<ftxui::Node> gen_caravan_cached(ViewConfig *vc, Game *game, ViewCache *cache, CaravanName cn, bool top) {
+    ViewCached *cached = &cache->caravans[cn - CARAVAN_A];
+    uint64_t version = game->get_version();
+    int16_t highlight =
+        vc->highlight.option != NO_OPTION && vc->highlight.caravan_name == cn ?
+        vc->highlight.pos_caravan : VIEW_NO_HIGHLIGHT;
+
+    if (cached->element == nullptr || cached->version != version || cached->highlight != highlight) {
+        cached->element = gen_caravan(vc, game, cn, top);
+        cached->version = version;
+        cached->highlight = highlight;
+    }
+
+    return cached->element;
+}
+
+/**
+ * Generate a player's hand only if the game or the hand's highlight has
+ * changed since it was last generated, otherwise reuse it.
+ */
+std::shared_ptr<ftxui::Node> gen_deck_cached(ViewConfig *vc, Game *game, ViewCache *cache, bool top) {
+    ViewCached *cached = &cache->decks[top ? 0 : 1];
+    uint64_t version = game->get_version();
+    int16_t highlight =
+        vc->user_turn->get_name() == (top ? PLAYER_DEF : PLAYER_ABC) && vc->highlight.option != NO_OPTION ?
+        vc->highlight.pos_hand : VIEW_NO_HIGHLIGHT;
+
+    if (cached->element == nullptr || cached->version != version || cached->highlight != highlight) {
+        cached->element = gen_deck(vc, game, top);
+        cached->version = version;
+        cached->highlight = highlight;
+    }
+
+    return cached->element;
+}
+
 std::shared_ptr<ftxui::Node> gen_input(
     ViewConfig *vc,
     Game *game,
@@ -723,31 +524,32 @@ std::shared_ptr<ftxui::Node> gen_input(
 std::shared_ptr<ftxui::Node> gen_game(
     ViewConfig *vc,
     Game *game,
+    ViewCache *cache,
     std::shared_ptr<ftxui::ComponentBase> *comp_user_input) {
     using namespace ftxui;
     return hbox({
                     vbox({  // GAME AREA
 
                              hbox({  // TOP GAME AREA
-                                      gen_caravan(vc, game, CARAVAN_D, true),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_D, true),
                                       separatorEmpty(),
                                       separatorEmpty(),
-                                      gen_caravan(vc, game, CARAVAN_E, true),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_E, true),
                                       separatorEmpty(),
                                       separatorEmpty(),
-                                      gen_caravan(vc, game, CARAVAN_F, true),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_F, true),
                                   }),  // top game area
 
                              separatorEmpty(),
 
                              hbox({  // BOTTOM GAME AREA
-                                      gen_caravan(vc, game, CARAVAN_A, false),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_A, false),
                                       separatorEmpty(),
                                       separatorEmpty(),
-                                      gen_caravan(vc, game, CARAVAN_B, false),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_B, false),
                                       separatorEmpty(),
                                       separatorEmpty(),
-                                      gen_caravan(vc, game, CARAVAN_C, false),
+                                      gen_caravan_cached(vc, game, cache, CARAVAN_C, false),
                                   }),  // bottom game area
 
                          }),  // game area
@@ -759,9 +561,9 @@ std::shared_ptr<ftxui::Node> gen_game(
                     separatorEmpty(),
 
                     vbox({  // DECK AREA
-                             gen_deck(vc, game, true),
+                             gen_deck_cached(vc, game, cache, true),
                              separatorEmpty(),
-                             gen_deck(vc, game, false),
+                             gen_deck_cached(vc, game, cache, false),
                          }) | vcenter,  // deck area
 
                     separatorEmpty(),
@@ -851,10 +653,172 @@ void set_current_turn(ViewConfig *vc, Game *game) {
     }
 }
 
+/*
+ * PROTECTED
+ */
+
+void ViewTimer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!closed) {
+        if (!pending) {
+            cv.wait(lock);
+
+        } else if (std::chrono::steady_clock::now() < deadline) {
+            cv.wait_until(lock, deadline);
+
+        } else {
+            pending = false;
+            screen->PostEvent(ftxui::Event::Custom);
+        }
+    }
+}
+
+void ViewBotTask::run(User *bot) {
+    GameCommand result{};
+    std::string error;
+
+    try {
+        Game copy{&snapshot};
+
+        result = bot->request_command(&copy);
+        copy.close();
+
+    } catch (CaravanException &e) {
+        error = e.what();
+
+    } catch (std::exception &e) {
+        error = "A fatal error occurred.";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        command = result;
+        msg_error = error;
+        state = BOT_DONE;
+    }
+
+    screen->PostEvent(ftxui::Event::Custom);
+}
+
 /*
  * PUBLIC
  */
 
+ViewBotTask::ViewBotTask(ftxui::ScreenInteractive *s) :
+    screen(s),
+    snapshot({}),
+    command({}),
+    state(BOT_IDLE),
+    closed(false) {}
+
+/**
+ * Wait for any bot that is still thinking; its command is dropped.
+ */
+void ViewBotTask::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (closed) { return; }
+        closed = true;
+    }
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool ViewBotTask::is_idle() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return state == BOT_IDLE;
+}
+
+/**
+ * Start asking a bot for its command, unless it is already being asked or
+ * its last command has not yet been taken.
+ *
+ * @param bot The bot whose turn it is.
+ * @param game The game, which is copied before the bot sees it.
+ *
+ * @throws CaravanFatalException Bot task is closed.
+ */
+void ViewBotTask::start(User *bot, Game *game) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (closed) { throw CaravanFatalException("Bot task is closed."); }
+    if (state != BOT_IDLE) { return; }
+
+    // The previous worker has published its command, so it is finishing
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    snapshot = game->clone();
+    state = BOT_RUNNING;
+    thread = std::thread(&ViewBotTask::run, this, bot);
+}
+
+/**
+ * @param out The bot's command, if it is ready.
+ * @return True if the command was ready and has been taken.
+ *
+ * @throws CaravanFatalException The bot failed to give a command.
+ */
+bool ViewBotTask::take(GameCommand *out) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (state != BOT_DONE) { return false; }
+
+    state = BOT_IDLE;
+
+    if (!msg_error.empty()) {
+        throw CaravanFatalException(msg_error);
+    }
+
+    *out = command;
+    return true;
+}
+
+ViewTimer::ViewTimer(ftxui::ScreenInteractive *s) :
+    screen(s),
+    pending(false),
+    closed(false) {
+
+    thread = std::thread(&ViewTimer::run, this);
+}
+
+void ViewTimer::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (closed) { return; }
+        closed = true;
+    }
+
+    cv.notify_all();
+    thread.join();
+}
+
+/**
+ * Schedule the screen to be woken, replacing any wake-up already scheduled.
+ *
+ * @param millis Milliseconds from now.
+ */
+void ViewTimer::wake_in(uint64_t millis) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (closed) { return; }
+
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(millis);
+        pending = true;
+    }
+
+    cv.notify_all();
+}
+
 void ViewTUI::run() {
     using namespace ftxui;
 
@@ -918,6 +882,12 @@ void ViewTUI::run() {
     // Monitor bot delay
     uint64_t time_bot_start = time_milliseconds();
     uint64_t time_bot_end;
+    uint64_t time_bot_delay = vc->bot_delay_sec * 1000;
+    ViewTimer timer{&screen};
+    ViewBotTask bot_task{&screen};
+
+    // Caravans and hands that are reused until the game changes
+    ViewCache cache;
 
     // Tweak how the component tree is rendered:
     auto renderer = Renderer(component, [&] {
@@ -947,7 +917,7 @@ void ViewTUI::run() {
                 vc->msg_main = "WINNER: " + name_winner;
                 vc->msg_important = "Press Esc to exit.";
 
-                return gen_game(vc, game, &comp_user_input);
+                return gen_game(vc, game, &cache, &comp_user_input);
             }
 
             if(vc->user_turn->is_human()) {
@@ -965,16 +935,26 @@ void ViewTUI::run() {
                 user_input = "";
                 time_bot_end = time_milliseconds();
 
-                if((float) (time_bot_end-time_bot_start) >= (vc->bot_delay_sec * 1000)) {
-                    // Bot delay has elapsed, make move
-                    raw_command = vc->user_turn->request_move(game);
+                // Bot works out its move away from the render thread
+                if(bot_task.is_idle()) {
+                    bot_task.start(vc->user_turn, game);
+                }
+
+                if(time_bot_end - time_bot_start >= time_bot_delay && bot_task.take(&vc->command)) {
+                    // Bot delay has elapsed and its move is ready; its
+                    // command is only formatted so that it can be shown
+                    raw_command = format_command(&vc->command);
                     confirmed = true;
 
                 } else {
                     // Bot is still thinking of its next move
                     vc->msg_important = vc->name_turn + " is thinking...";
-                    // Event needed so that delay checks occur
-                    screen.PostEvent(Event::Custom);
+
+                    // Redraw once the delay is over, rather than every frame;
+                    // the bot task wakes the screen when the move is ready
+                    if(time_bot_end - time_bot_start < time_bot_delay) {
+                        timer.wake_in(time_bot_delay - (time_bot_end - time_bot_start));
+                    }
                 }
             }
 
@@ -983,10 +963,11 @@ void ViewTUI::run() {
             }
 
             try {
-                if(confirmed) {
+                // Bots give a usable command, so only human input is parsed
+                if(vc->user_turn->is_human() && confirmed) {
                     // Parse raw command to get usable command
                     vc->command = parse_user_input(raw_command, confirmed);
-                } else {
+                } else if(vc->user_turn->is_human()) {
                     // An incomplete command that can be used to highlight
                     // areas of the board as a hint to the player
                     vc->highlight = parse_user_input(raw_command, confirmed);
@@ -1018,6 +999,12 @@ void ViewTUI::run() {
                         if(!vc->user_next->is_human()) {
                             time_bot_start = time_milliseconds();
                         }
+
+                        // If a bot moved against a human, let it keep
+                        // searching during the human's turn
+                        if(!vc->user_turn->is_human() && vc->user_next->is_human()) {
+                            vc->user_turn->ponder_start(game);
+                        }
                 }
 
             } catch (CaravanGameException &e) {
@@ -1027,7 +1014,7 @@ void ViewTUI::run() {
                 vc->msg_important = e.what();
             }
 
-            return gen_game(vc, game, &comp_user_input);
+            return gen_game(vc, game, &cache, &comp_user_input);
 
         } catch (CaravanException &e) {
             // Close gracefully on any unhandled exceptions
@@ -1052,6 +1039,8 @@ void ViewTUI::run() {
     });
 
     screen.Loop(renderer);
+    bot_task.close();
+    timer.close();
     screen.Clear();
 }
 
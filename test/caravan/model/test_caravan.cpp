@@ -9,7 +9,8 @@
 
 
 TEST (TestCaravan, Clear_ThreeNumeric) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     Card c_num_3 = {SPADES, THREE};
@@ -26,7 +27,8 @@ TEST (TestCaravan, Clear_ThreeNumeric) {
 }
 
 TEST (TestCaravan, Clear_Error_EmptyCaravan) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
 
     try {
         cvn.clear();
@@ -40,7 +42,8 @@ TEST (TestCaravan, Clear_Error_EmptyCaravan) {
 }
 
 TEST (TestCaravan, GetBid_ThreeNumeric) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     Card c_num_3 = {SPADES, THREE};
@@ -55,7 +58,8 @@ TEST (TestCaravan, GetBid_ThreeNumeric) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankAce) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -64,7 +68,8 @@ TEST (TestCaravan, GetBid_Value_RankAce) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankTwo) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, TWO};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -73,7 +78,8 @@ TEST (TestCaravan, GetBid_Value_RankTwo) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankThree) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, THREE};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -82,7 +88,8 @@ TEST (TestCaravan, GetBid_Value_RankThree) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankFour) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, FOUR};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -91,7 +98,8 @@ TEST (TestCaravan, GetBid_Value_RankFour) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankFive) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, FIVE};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -100,7 +108,8 @@ TEST (TestCaravan, GetBid_Value_RankFive) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankSix) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, SIX};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -109,7 +118,8 @@ TEST (TestCaravan, GetBid_Value_RankSix) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankSeven) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, SEVEN};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -118,7 +128,8 @@ TEST (TestCaravan, GetBid_Value_RankSeven) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankEight) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, EIGHT};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -127,7 +138,8 @@ TEST (TestCaravan, GetBid_Value_RankEight) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankNine) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, NINE};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -136,7 +148,8 @@ TEST (TestCaravan, GetBid_Value_RankNine) {
 }
 
 TEST (TestCaravan, GetBid_Value_RankTen) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, TEN};
 
     ASSERT_EQ(cvn.get_bid(), 0);
@@ -145,7 +158,8 @@ TEST (TestCaravan, GetBid_Value_RankTen) {
 }
 
 TEST (TestCaravan, GetCardsAt_TwoNumeric_OneFace) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_face_1 = {DIAMONDS, KING};
@@ -169,7 +183,8 @@ TEST (TestCaravan, GetCardsAt_TwoNumeric_OneFace) {
 }
 
 TEST (TestCaravan, GetCardsAt_Error_OneNumeric_OutOfRange) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
 
     cvn.put_numeral_card(c_num);
@@ -186,7 +201,8 @@ TEST (TestCaravan, GetCardsAt_Error_OneNumeric_OutOfRange) {
 }
 
 TEST (TestCaravan, GetDirection_Ascending) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
 
@@ -198,7 +214,8 @@ TEST (TestCaravan, GetDirection_Ascending) {
 }
 
 TEST (TestCaravan, GetDirection_Descending) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, TWO};
     Card c_num_2 = {SPADES, ACE};
 
@@ -210,7 +227,8 @@ TEST (TestCaravan, GetDirection_Descending) {
 }
 
 TEST (TestCaravan, GetDirection_Ascending_ThreeQueens) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_face_1 = {CLUBS, QUEEN};
@@ -232,7 +250,8 @@ TEST (TestCaravan, GetDirection_Ascending_ThreeQueens) {
 }
 
 TEST (TestCaravan, GetDirection_Descending_ThreeQueens) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, TEN};
     Card c_num_2 = {HEARTS, NINE};
     Card c_face_1 = {CLUBS, QUEEN};
@@ -254,12 +273,14 @@ TEST (TestCaravan, GetDirection_Descending_ThreeQueens) {
 }
 
 TEST (TestCaravan, GetName) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     ASSERT_EQ(cvn.get_name(), CARAVAN_D);
 }
 
 TEST (TestCaravan, GetSize_BeforeAfterNumeric) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
 
     ASSERT_EQ(cvn.get_size(), 0);
@@ -268,7 +289,8 @@ TEST (TestCaravan, GetSize_BeforeAfterNumeric) {
 }
 
 TEST (TestCaravan, GetSuit) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
 
     ASSERT_EQ(cvn.get_suit(), NO_SUIT);
@@ -277,7 +299,8 @@ TEST (TestCaravan, GetSuit) {
 }
 
 TEST (TestCaravan, PutNumericCard_PutFaceNotJack) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
     Card c_face = {HEARTS, KING};
     Slot ts;
@@ -296,7 +319,8 @@ TEST (TestCaravan, PutNumericCard_PutFaceNotJack) {
 }
 
 TEST (TestCaravan, PutNumericCard_PutFaceJack) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
     Card c_face = {HEARTS, JACK};
 
@@ -308,7 +332,8 @@ TEST (TestCaravan, PutNumericCard_PutFaceJack) {
 }
 
 TEST (TestCaravan, PutNumericCard_Error_NotNumeric) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_face = {HEARTS, KING};
 
     try {
@@ -323,7 +348,8 @@ TEST (TestCaravan, PutNumericCard_Error_NotNumeric) {
 }
 
 TEST (TestCaravan, PutNumericCard_Error_CaravanFull) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, THREE};
     Card c_num_3 = {SPADES, FIVE};
@@ -357,7 +383,8 @@ TEST (TestCaravan, PutNumericCard_Error_CaravanFull) {
 }
 
 TEST (TestCaravan, PutFaceCard) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
     Card c_face = {HEARTS, KING};
     Slot ts;
@@ -374,7 +401,8 @@ TEST (TestCaravan, PutFaceCard) {
 }
 
 TEST (TestCaravan, PutFaceCard_Error_EmptyCaravan) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_face = {HEARTS, KING};
     Slot ts;
 
@@ -390,7 +418,8 @@ TEST (TestCaravan, PutFaceCard_Error_EmptyCaravan) {
 }
 
 TEST (TestCaravan, PutFaceCard_Error_OutOfRange) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
     Card c_face = {HEARTS, KING};
     Slot ts;
@@ -409,7 +438,8 @@ TEST (TestCaravan, PutFaceCard_Error_OutOfRange) {
 }
 
 TEST (TestCaravan, PutFaceCard_Error_NotFaceCard) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     Slot ts;
@@ -428,7 +458,8 @@ TEST (TestCaravan, PutFaceCard_Error_NotFaceCard) {
 }
 
 TEST (TestCaravan, PutFaceCard_Error_FullFaceCardCapacity) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num = {SPADES, ACE};
     Card c_face_1 = {HEARTS, KING};
     Card c_face_2 = {HEARTS, KING};
@@ -455,7 +486,8 @@ TEST (TestCaravan, PutFaceCard_Error_FullFaceCardCapacity) {
 }
 
 TEST (TestCaravan, RemoveRank_FiveNumeric_OneFace) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -485,7 +517,8 @@ TEST (TestCaravan, RemoveRank_FiveNumeric_OneFace) {
 }
 
 TEST (TestCaravan, RemoveRank_FiveNumeric_OneFace_ExcludeOne) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -517,8 +550,50 @@ TEST (TestCaravan, RemoveRank_FiveNumeric_OneFace_ExcludeOne) {
     ASSERT_EQ(cvn.get_slot(4).card.rank, ACE);
 }
 
+TEST (TestCaravan, RemoveRank_Several_KeepsOrderAndBid) {
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
+    Card c_num_1 = {SPADES, THREE};
+    Card c_num_2 = {HEARTS, FOUR};
+    Card c_num_3 = {HEARTS, THREE};
+    Card c_num_4 = {HEARTS, SIX};
+    Card c_num_5 = {HEARTS, THREE};
+    Card c_face = {HEARTS, KING};
+
+    cvn.put_numeral_card(c_num_1);
+    cvn.put_numeral_card(c_num_2);
+    cvn.put_numeral_card(c_num_3);
+    cvn.put_numeral_card(c_num_4);
+    cvn.put_numeral_card(c_num_5);
+    cvn.put_face_card(c_face, 4);
+    ASSERT_EQ(cvn.get_bid(), 25);
+
+    // No card of the rank, so nothing changes
+    cvn.remove_rank(NINE, 0);
+    ASSERT_EQ(cvn.get_size(), 5);
+    ASSERT_EQ(cvn.get_bid(), 25);
+
+    cvn.remove_rank(THREE, 0);
+    ASSERT_EQ(cvn.get_size(), 2);
+    ASSERT_EQ(cvn.get_bid(), 16);
+
+    ASSERT_EQ(cvn.get_slot(1).card.suit, HEARTS);
+    ASSERT_EQ(cvn.get_slot(1).card.rank, FOUR);
+
+    ASSERT_EQ(cvn.get_slot(2).card.suit, HEARTS);
+    ASSERT_EQ(cvn.get_slot(2).card.rank, SIX);
+    ASSERT_EQ(cvn.get_slot(2).i_faces, 1);
+
+    // The removed rank is no longer present
+    cvn.remove_suit(SPADES, 0);
+    cvn.remove_rank(THREE, 0);
+    ASSERT_EQ(cvn.get_size(), 2);
+    ASSERT_EQ(cvn.get_direction(), ASCENDING);
+}
+
 TEST (TestCaravan, RemoveRank_Error_ExcludeOutOfRange) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -545,7 +620,8 @@ TEST (TestCaravan, RemoveRank_Error_ExcludeOutOfRange) {
 }
 
 TEST (TestCaravan, RemoveSuit_FiveNumeric_OneFace) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -576,7 +652,8 @@ TEST (TestCaravan, RemoveSuit_FiveNumeric_OneFace) {
 
 
 TEST (TestCaravan, RemoveSuit_FiveNumeric_OneFace_ExcludeOne) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -609,7 +686,8 @@ TEST (TestCaravan, RemoveSuit_FiveNumeric_OneFace_ExcludeOne) {
 }
 
 TEST (TestCaravan, RemoveSuit_Error_ExcludeOutOfRange) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, TWO};
     Card c_num_3 = {CLUBS, FIVE};
@@ -636,7 +714,8 @@ TEST (TestCaravan, RemoveSuit_Error_ExcludeOutOfRange) {
 }
 
 TEST (TestCaravan, RemoveNumericCard_WithJack_Position8) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
 
     cvn.put_numeral_card({SPADES, ACE});
     cvn.put_numeral_card({SPADES, TWO});
@@ -672,7 +751,8 @@ TEST (TestCaravan, RemoveNumericCard_WithJack_Position8) {
 
 
 TEST (TestCaravan, RemoveNumericCard_WithJack_Position1) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
 
     cvn.put_numeral_card({SPADES, ACE});
     cvn.put_numeral_card({SPADES, TWO});
@@ -707,7 +787,8 @@ TEST (TestCaravan, RemoveNumericCard_WithJack_Position1) {
 }
 
 TEST (TestCaravan, RemoveNumericCard_WithJack_Position5) {
-    auto cvn = Caravan(CARAVAN_D);
+    CaravanState state{};
+    Caravan cvn{CARAVAN_D, &state};
 
     cvn.put_numeral_card({SPADES, ACE});
     cvn.put_numeral_card({SPADES, TWO});
@@ -743,3 +824,25 @@ TEST (TestCaravan, RemoveNumericCard_WithJack_Position5) {
         FAIL();
     }
 }
+
+TEST (TestCaravan, Unchecked_MatchesChecked) {
+    CaravanState state{};
+    Caravan cvn{CARAVAN_B, &state};
+    Card c_num_1 = {SPADES, FOUR};
+    Card c_num_2 = {HEARTS, SEVEN};
+    Card c_face = {CLUBS, KING};
+
+    cvn.put_numeral_card(c_num_1);
+    cvn.put_numeral_card(c_num_2);
+    cvn.put_face_card(c_face, 2);
+
+    ASSERT_EQ(cvn.bid(), cvn.get_bid());
+    ASSERT_EQ(cvn.size(), cvn.get_size());
+    ASSERT_EQ(cvn.direction(), cvn.get_direction());
+    ASSERT_EQ(cvn.suit(), cvn.get_suit());
+
+    for (uint8_t pos = 1; pos <= cvn.size(); ++pos) {
+        ASSERT_EQ(cvn.slot(pos).card.rank, cvn.get_slot(pos).card.rank);
+        ASSERT_EQ(cvn.slot(pos).i_faces, cvn.get_slot(pos).i_faces);
+    }
+}
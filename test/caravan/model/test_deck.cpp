@@ -185,4 +185,117 @@ TEST (TestDeck, CaravanDeck_Error_InsufficientSampleCards) {
     } catch (...) {
         FAIL();
     }
-}
\ No newline at end of file
+}
+
+TEST (TestDeck, CaravanDeck_SameSeed_SameDeck) {
+    for (bool balanced: {true, false}) {
+        Random rng_first(42);
+        Random rng_second(42);
+        Deck *d_first = DeckBuilder::build_caravan_deck(100, 2, balanced, &rng_first);
+        Deck *d_second = DeckBuilder::build_caravan_deck(100, 2, balanced, &rng_second);
+
+        ASSERT_EQ(d_first->size(), d_second->size());
+
+        for (size_t i = 0; i < d_first->size(); ++i) {
+            ASSERT_EQ(d_first->at(i).suit, d_second->at(i).suit);
+            ASSERT_EQ(d_first->at(i).rank, d_second->at(i).rank);
+        }
+
+        delete d_first;
+        delete d_second;
+    }
+}
+
+TEST (TestDeck, CaravanDeck_DifferentSeed_DifferentDeck) {
+    Random rng_first(1);
+    Random rng_second(2);
+    Deck *d_first = DeckBuilder::build_caravan_deck(54, 1, true, &rng_first);
+    Deck *d_second = DeckBuilder::build_caravan_deck(54, 1, true, &rng_second);
+    bool differs = false;
+
+    for (size_t i = 0; i < d_first->size(); ++i) {
+        differs = differs or
+                  d_first->at(i).suit != d_second->at(i).suit or
+                  d_first->at(i).rank != d_second->at(i).rank;
+    }
+
+    ASSERT_TRUE(differs);
+
+    delete d_first;
+    delete d_second;
+}
+
+TEST (TestDeck, CaravanDeck_FixedStorage_ValidDecks) {
+    Random rng(2024);
+    DeckCards deck;
+
+    for (int n = 0; n < 2000; ++n) {
+        uint8_t num_samples = 1 + n % SAMPLE_DECKS_MAX;
+        uint8_t num_cards = DECK_CARAVAN_MIN + rng.below(num_samples * DECK_TRADITIONAL_MAX - DECK_CARAVAN_MIN + 1);
+        bool balanced = n % 2 == 0;
+        std::array<uint8_t, 5 * 14> counts{};
+        uint8_t sum_num = 0;
+
+        DeckBuilder::build_caravan_deck(&deck, num_cards, num_samples, balanced, &rng);
+
+        for (int i = 0; i < num_cards; ++i) {
+            counts[deck[i].suit * 14 + deck[i].rank] += 1;
+
+            if (i >= num_cards - HAND_SIZE_MAX_START and is_numeral_card(deck[i])) {
+                sum_num += 1;
+            }
+        }
+
+        // No card appears more often than the sample decks hold it
+        for (int s = CLUBS; s <= SPADES; ++s) {
+            for (int r = ACE; r <= KING; ++r) {
+                ASSERT_LE(counts[s * 14 + r], num_samples);
+            }
+        }
+
+        ASSERT_LE(counts[NO_SUIT * 14 + JOKER], 2 * num_samples);
+        ASSERT_GE(sum_num, MOVES_START_ROUND);
+    }
+}
+
+TEST (TestDeck, CaravanDeck_FixedStorage_OpeningHandDistribution) {
+    Random rng(7);
+    DeckCards deck;
+    std::array<double, 9> expected{};
+    std::array<uint32_t, 9> observed{};
+    double total = 0;
+    int num_decks = 20000;
+
+    // Numerals in 8 cards drawn from one deck, given at least 3 of them
+    for (int k = MOVES_START_ROUND; k <= 8; ++k) {
+        double p = 1;
+
+        for (int i = 0; i < 8; ++i) {
+            p *= i < k ? (40.0 - i) / (54 - i) : (14.0 - (i - k)) / (54 - i);
+        }
+
+        for (int i = 0; i < k; ++i) {
+            p *= (8.0 - i) / (i + 1);
+        }
+
+        expected[k] = p;
+        total += p;
+    }
+
+    for (int n = 0; n < num_decks; ++n) {
+        uint8_t sum_num = 0;
+
+        DeckBuilder::build_caravan_deck(&deck, 54, 1, true, &rng);
+
+        for (int i = 54 - HAND_SIZE_MAX_START; i < 54; ++i) {
+            sum_num += is_numeral_card(deck[i]) ? 1 : 0;
+        }
+
+        observed[sum_num] += 1;
+    }
+
+    for (int k = 0; k <= 8; ++k) {
+        double freq = (double) observed[k] / num_decks;
+        ASSERT_NEAR(freq, expected[k] / total, 0.01);
+    }
+}
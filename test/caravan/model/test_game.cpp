@@ -2,6 +2,9 @@
 // The following code can be redistributed and/or
 // modified under the terms of the GPL-3.0 License.
 
+#include <cstring>
+#include <random>
+#include <vector>
 #include "gtest/gtest.h"
 #include "caravan/model/game.h"
 
@@ -217,3 +220,593 @@ TEST (TestGame, PlayOption_Error_StartRound_Clear) {
         FAIL();
     }
 }
+
+TEST (TestGame, Clone_UnchangedByLaterMoves) {
+    GameConfig gc = {
+        30, 1, true,
+        30, 1, true,
+        PLAYER_ABC
+    };
+    Game g{&gc};
+    Player *pa = g.get_player(PLAYER_ABC);
+    uint8_t pos_hand = 1;
+
+    while (!is_numeral_card(pa->get_from_hand_at(pos_hand))) { pos_hand++; }
+
+    GameCommand command = {OPTION_PLAY, pos_hand, CARAVAN_A, 0};
+    GameState gs = g.clone();
+    g.play_option(&command);
+
+    ASSERT_EQ(g.get_player_turn(), PLAYER_DEF);
+    ASSERT_EQ(g.get_table()->get_caravan(CARAVAN_A)->get_size(), 1);
+    ASSERT_EQ(pa->get_size_hand(), 7);
+
+    ASSERT_EQ(gs.p_turn, PLAYER_ABC);
+    ASSERT_EQ(gs.table[0].i_track, 0);
+    ASSERT_EQ(gs.pa.i_hand, 8);
+}
+
+TEST (TestGame, Restore_RevertsMove) {
+    GameConfig gc = {
+        30, 1, true,
+        30, 1, true,
+        PLAYER_ABC
+    };
+    Game g{&gc};
+    Player *pa = g.get_player(PLAYER_ABC);
+    uint8_t pos_hand = 1;
+
+    while (!is_numeral_card(pa->get_from_hand_at(pos_hand))) { pos_hand++; }
+
+    GameCommand command = {OPTION_PLAY, pos_hand, CARAVAN_A, 0};
+    GameState gs = g.clone();
+    g.play_option(&command);
+    g.restore(&gs);
+
+    ASSERT_EQ(g.get_player_turn(), PLAYER_ABC);
+    ASSERT_EQ(g.get_table()->get_caravan(CARAVAN_A)->get_size(), 0);
+    ASSERT_EQ(pa->get_size_hand(), 8);
+    ASSERT_EQ(pa->get_moves_count(), 0);
+}
+
+TEST (TestGame, FromState_MatchesOriginal) {
+    GameConfig gc = {
+        30, 1, true,
+        30, 1, true,
+        PLAYER_DEF
+    };
+    Game g{&gc};
+    GameState gs = g.clone();
+    Game g_copy{&gs};
+
+    ASSERT_EQ(g_copy.get_player_turn(), PLAYER_DEF);
+
+    for (PlayerName pn: {PLAYER_ABC, PLAYER_DEF}) {
+        Player *p = g.get_player(pn);
+        Player *p_copy = g_copy.get_player(pn);
+
+        ASSERT_EQ(p_copy->get_size_deck(), p->get_size_deck());
+        ASSERT_EQ(p_copy->get_size_hand(), p->get_size_hand());
+
+        for (uint8_t pos = 1; pos <= p->get_size_hand(); ++pos) {
+            ASSERT_EQ(p_copy->get_from_hand_at(pos).suit, p->get_from_hand_at(pos).suit);
+            ASSERT_EQ(p_copy->get_from_hand_at(pos).rank, p->get_from_hand_at(pos).rank);
+        }
+    }
+}
+
+TEST (TestGame, LegalMoves_StartRound) {
+    GameConfig gc = {
+        30, 1, true,
+        30, 1, true,
+        PLAYER_ABC
+    };
+    Game g{&gc};
+    GameCommandList moves;
+    uint8_t num_numerals = 0;
+
+    for (uint8_t pos = 1; pos <= 8; ++pos) {
+        if (is_numeral_card(g.get_player(PLAYER_ABC)->get_from_hand_at(pos))) {
+            num_numerals += 1;
+        }
+    }
+
+    g.legal_moves(PLAYER_ABC, &moves);
+
+    // Every numeral can start any of the player's three caravans
+    ASSERT_EQ(moves.size, num_numerals * 3);
+
+    for (uint8_t i = 0; i < moves.size; ++i) {
+        ASSERT_EQ(moves.commands[i].option, OPTION_PLAY);
+        ASSERT_TRUE(moves.commands[i].caravan_name >= CARAVAN_A);
+        ASSERT_TRUE(moves.commands[i].caravan_name <= CARAVAN_C);
+    }
+}
+
+TEST (TestGame, LegalMoves_MatchPlayOption) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC
+    };
+    std::mt19937 gen(1234);
+
+    for (int n = 0; n < 10; ++n) {
+        Game g{&gc};
+        GameCommandList moves;
+
+        while (g.get_winner() == NO_PLAYER) {
+            GameState gs = g.clone();
+            PlayerName pturn = g.get_player_turn();
+            uint8_t size_hand = g.get_player(pturn)->get_size_hand();
+            uint8_t num_legal = 0;
+
+            g.legal_moves(pturn, &moves);
+            ASSERT_GT(moves.size, 0);
+
+            // Every command that play_option accepts must be listed
+            for (int opt = OPTION_PLAY; opt <= OPTION_CLEAR; ++opt) {
+                for (uint8_t pos_hand = 0; pos_hand <= size_hand; ++pos_hand) {
+                    for (int cvn = NO_CARAVAN; cvn <= CARAVAN_F; ++cvn) {
+                        for (uint8_t pos_cvn = 0; pos_cvn <= TRACK_NUMERIC_MAX; ++pos_cvn) {
+                            GameCommand c = {
+                                static_cast<OptionType>(opt), pos_hand,
+                                static_cast<CaravanName>(cvn), pos_cvn};
+                            bool accepted = true;
+
+                            // Fields that an option ignores are left at zero
+                            if ((opt == OPTION_DISCARD and (cvn != NO_CARAVAN or pos_cvn != 0)) or
+                                (opt == OPTION_CLEAR and (pos_hand != 0 or pos_cvn != 0)) or
+                                (opt == OPTION_PLAY and pos_hand > 0 and pos_cvn != 0 and
+                                 is_numeral_card(g.get_player(pturn)->get_from_hand_at(pos_hand)))) {
+                                continue;
+                            }
+
+                            try {
+                                g.play_option(&c);
+                            } catch (CaravanException &e) {
+                                accepted = false;
+                            }
+
+                            g.restore(&gs);
+
+                            bool listed = false;
+                            for (uint8_t i = 0; i < moves.size; ++i) {
+                                GameCommand m = moves.commands[i];
+                                listed = listed or (
+                                    m.option == c.option and
+                                    m.pos_hand == c.pos_hand and
+                                    m.caravan_name == c.caravan_name and
+                                    m.pos_caravan == c.pos_caravan);
+                            }
+
+                            ASSERT_EQ(accepted, listed);
+                            num_legal += accepted ? 1 : 0;
+                        }
+                    }
+                }
+            }
+
+            ASSERT_EQ(num_legal, moves.size);
+
+            GameCommand chosen = moves.commands[gen() % moves.size];
+            g.play_option(&chosen);
+        }
+
+        g.close();
+    }
+}
+
+TEST (TestGame, Unplay_RestoresState_RandomPlay) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC
+    };
+    std::mt19937 gen(4321);
+
+    for (int n = 0; n < 50; ++n) {
+        Game g{&gc};
+        GameCommandList moves;
+        GameUndo undo;
+
+        while (g.get_winner() == NO_PLAYER) {
+            GameState gs = g.clone();
+
+            g.legal_moves(g.get_player_turn(), &moves);
+            ASSERT_GT(moves.size, 0);
+
+            // Try every legal move and check each one is reverted exactly
+            for (uint8_t i = 0; i < moves.size; ++i) {
+                GameCommand command = moves.commands[i];
+                g.play_option(&command, &undo);
+                g.unplay(&undo);
+
+                GameState gs_after = g.clone();
+                ASSERT_EQ(memcmp(&gs, &gs_after, sizeof(GameState)), 0);
+            }
+
+            GameCommand chosen = moves.commands[gen() % moves.size];
+            g.play_option(&chosen);
+        }
+
+        g.close();
+    }
+}
+
+TEST (TestGame, Unplay_RestoresState_WholeGame) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_DEF
+    };
+    std::mt19937 gen(99);
+    Game g{&gc};
+    GameState gs = g.clone();
+    GameCommandList moves;
+    std::vector<GameUndo> undos;
+
+    while (g.get_winner() == NO_PLAYER) {
+        g.legal_moves(g.get_player_turn(), &moves);
+
+        GameCommand chosen = moves.commands[gen() % moves.size];
+        undos.emplace_back();
+        g.play_option(&chosen, &undos.back());
+    }
+
+    while (!undos.empty()) {
+        g.unplay(&undos.back());
+        undos.pop_back();
+    }
+
+    GameState gs_after = g.clone();
+    ASSERT_EQ(g.get_player_turn(), PLAYER_DEF);
+    ASSERT_EQ(memcmp(&gs, &gs_after, sizeof(GameState)), 0);
+}
+
+uint64_t hash_from_scratch(GameState *gs) {
+    uint64_t hash = zobrist_turn(gs->p_turn);
+
+    for (uint8_t i = 0; i < TABLE_CARAVANS_MAX; ++i) {
+        CaravanName cvname = static_cast<CaravanName>(i + 1);
+        CaravanState *cs = &gs->table[i];
+
+        for (uint8_t t = 0; t < cs->i_track; ++t) {
+            hash ^= zobrist_track(cvname, t, 0, cs->track[t].card);
+
+            for (uint8_t f = 0; f < cs->track[t].i_faces; ++f) {
+                hash ^= zobrist_track(cvname, t, f + 1, cs->track[t].faces[f]);
+            }
+        }
+    }
+
+    for (PlayerName pn: {PLAYER_ABC, PLAYER_DEF}) {
+        PlayerState *ps = pn == PLAYER_ABC ? &gs->pa : &gs->pb;
+
+        for (uint8_t h = 0; h < ps->i_hand; ++h) {
+            hash ^= zobrist_hand(pn, h, ps->hand[h]);
+        }
+
+        for (uint8_t d = 0; d < ps->i_deck; ++d) {
+            hash ^= zobrist_deck(pn, d, ps->deck[d]);
+        }
+    }
+
+    return hash;
+}
+
+TEST (TestGame, GetHash_MatchesState_RandomPlay) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC
+    };
+    std::mt19937 gen(777);
+
+    for (int n = 0; n < 50; ++n) {
+        Game g{&gc};
+        GameCommandList moves;
+
+        while (g.get_winner() == NO_PLAYER) {
+            GameState gs = g.clone();
+            ASSERT_EQ(g.get_hash(), hash_from_scratch(&gs));
+
+            g.legal_moves(g.get_player_turn(), &moves);
+
+            GameCommand chosen = moves.commands[gen() % moves.size];
+            g.play_option(&chosen);
+
+            ASSERT_NE(g.get_hash(), hash_from_scratch(&gs));
+        }
+
+        GameState gs = g.clone();
+        ASSERT_EQ(g.get_hash(), hash_from_scratch(&gs));
+
+        g.close();
+    }
+}
+
+static PlayerName winner_from_scratch(Game *g) {
+    uint8_t won_abc = 0;
+    uint8_t won_def = 0;
+    uint8_t hand_abc = g->get_player(PLAYER_ABC)->get_size_hand();
+    uint8_t hand_def = g->get_player(PLAYER_DEF)->get_size_hand();
+
+    for (int i = 0; i < PLAYER_CARAVANS_MAX; ++i) {
+        uint16_t bid_abc = g->get_table()->get_caravan(static_cast<CaravanName>(CARAVAN_A + i))->get_bid();
+        uint16_t bid_def = g->get_table()->get_caravan(static_cast<CaravanName>(CARAVAN_D + i))->get_bid();
+        bool sold_abc = bid_abc >= CARAVAN_SOLD_MIN and bid_abc <= CARAVAN_SOLD_MAX;
+        bool sold_def = bid_def >= CARAVAN_SOLD_MIN and bid_def <= CARAVAN_SOLD_MAX;
+
+        if (sold_abc and (!sold_def or bid_abc > bid_def)) {
+            won_abc += 1;
+        } else if (sold_def and (!sold_abc or bid_def > bid_abc)) {
+            won_def += 1;
+        } else {
+            break;
+        }
+    }
+
+    if (won_abc + won_def == 3) {
+        return won_abc >= 2 ? PLAYER_ABC : PLAYER_DEF;
+    }
+
+    if (hand_abc > 0 and hand_def == 0) {
+        return PLAYER_ABC;
+    } else if (hand_abc == 0 and hand_def > 0) {
+        return PLAYER_DEF;
+    }
+
+    return NO_PLAYER;
+}
+
+TEST (TestGame, GetWinner_MatchesState_RandomPlayAndUnplay) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC
+    };
+    std::mt19937 gen(778);
+
+    for (int n = 0; n < 50; ++n) {
+        Game g{&gc};
+        GameCommandList moves;
+        GameUndo undo;
+
+        while (g.get_winner() == NO_PLAYER) {
+            g.legal_moves(g.get_player_turn(), &moves);
+
+            if (moves.size == 0) { break; }
+
+            // Play and take back a move, then play another for real
+            GameCommand tried = moves.commands[gen() % moves.size];
+            g.play_option(&tried, &undo);
+            ASSERT_EQ(g.get_winner(), winner_from_scratch(&g));
+
+            g.unplay(&undo);
+            ASSERT_EQ(g.get_winner(), winner_from_scratch(&g));
+
+            GameCommand chosen = moves.commands[gen() % moves.size];
+            g.play_option(&chosen);
+            ASSERT_EQ(g.get_winner(), winner_from_scratch(&g));
+        }
+
+        GameState gs = g.clone();
+        Game copy{&gs};
+        ASSERT_EQ(copy.get_winner(), g.get_winner());
+
+        copy.close();
+        g.close();
+    }
+}
+
+TEST (TestGame, Seed_SameSeed_SameGame) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, false,
+        PLAYER_ABC,
+        12345
+    };
+    Game g_first{&gc};
+    Game g_second{&gc};
+    GameState gs_first = g_first.clone();
+    GameState gs_second = g_second.clone();
+
+    ASSERT_EQ(g_first.get_hash(), g_second.get_hash());
+    ASSERT_EQ(memcmp(&gs_first.pa.deck, &gs_second.pa.deck, sizeof(DeckCards)), 0);
+    ASSERT_EQ(memcmp(&gs_first.pb.deck, &gs_second.pb.deck, sizeof(DeckCards)), 0);
+    ASSERT_EQ(memcmp(&gs_first.pa.hand, &gs_second.pa.hand, sizeof(Hand)), 0);
+    ASSERT_EQ(memcmp(&gs_first.pb.hand, &gs_second.pb.hand, sizeof(Hand)), 0);
+}
+
+TEST (TestGame, FormatCommand_ParsesBack) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC,
+        31
+    };
+    std::mt19937 gen(31);
+    Game g{&gc};
+    GameCommandList moves;
+
+    while (g.get_winner() == NO_PLAYER) {
+        g.legal_moves(g.get_player_turn(), &moves);
+
+        for (uint8_t i = 0; i < moves.size; ++i) {
+            GameCommand parsed;
+            parse_command(format_command(&moves.commands[i]), &parsed);
+
+            ASSERT_EQ(parsed.option, moves.commands[i].option);
+            ASSERT_EQ(parsed.pos_hand, moves.commands[i].pos_hand);
+            ASSERT_EQ(parsed.caravan_name, moves.commands[i].caravan_name);
+            ASSERT_EQ(parsed.pos_caravan, moves.commands[i].pos_caravan);
+        }
+
+        GameCommand chosen = moves.commands[gen() % moves.size];
+        g.play_option(&chosen);
+    }
+
+    g.close();
+}
+
+TEST (TestGame, Determinize_KeepsViewerView) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC,
+        5
+    };
+    std::mt19937 gen(5);
+    Random rng(5);
+    Game g{&gc};
+    GameCommandList moves;
+
+    for (int i = 0; i < 12; ++i) {
+        g.legal_moves(g.get_player_turn(), &moves);
+        GameCommand chosen = moves.commands[gen() % moves.size];
+        g.play_option(&chosen);
+    }
+
+    GameState gs = g.clone();
+    g.determinize(PLAYER_ABC, &rng);
+    GameState gs_det = g.clone();
+
+    // Everything the viewer sees is unchanged
+    ASSERT_EQ(memcmp(&gs.table, &gs_det.table, sizeof(TableState)), 0);
+    ASSERT_EQ(memcmp(&gs.pa.hand, &gs_det.pa.hand, sizeof(Hand)), 0);
+    ASSERT_EQ(gs.pa.i_deck, gs_det.pa.i_deck);
+    ASSERT_EQ(gs.pb.i_hand, gs_det.pb.i_hand);
+    ASSERT_EQ(gs.pb.i_deck, gs_det.pb.i_deck);
+
+    // The opponent holds the same cards, just rearranged
+    std::array<uint8_t, 5 * 14> counts{};
+
+    for (uint8_t i = 0; i < gs.pb.i_hand; ++i) {
+        counts[gs.pb.hand[i].suit * 14 + gs.pb.hand[i].rank] += 1;
+        counts[gs_det.pb.hand[i].suit * 14 + gs_det.pb.hand[i].rank] -= 1;
+    }
+
+    for (uint8_t i = 0; i < gs.pb.i_deck; ++i) {
+        counts[gs.pb.deck[i].suit * 14 + gs.pb.deck[i].rank] += 1;
+        counts[gs_det.pb.deck[i].suit * 14 + gs_det.pb.deck[i].rank] -= 1;
+    }
+
+    for (uint8_t c: counts) {
+        ASSERT_EQ(c, 0);
+    }
+
+    ASSERT_EQ(g.get_hash(), hash_from_scratch(&gs_det));
+
+    g.close();
+}
+
+/**
+ * @return True if the list holds the command, comparing only the fields that
+ *         play_option reads for its option and card.
+ */
+static bool lists_command(GameCommandList *moves, GameCommand *command) {
+    for (uint8_t i = 0; i < moves->size; ++i) {
+        GameCommand *m = &moves->commands[i];
+
+        if (m->option != command->option) { continue; }
+
+        if (m->option == OPTION_DISCARD and m->pos_hand == command->pos_hand) {
+            return true;
+        }
+
+        if (m->option == OPTION_CLEAR and m->caravan_name == command->caravan_name) {
+            return true;
+        }
+
+        if (m->option == OPTION_PLAY and
+            m->pos_hand == command->pos_hand and
+            m->caravan_name == command->caravan_name and
+            (is_numeral_card(m->hand) or m->pos_caravan == command->pos_caravan)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TEST (TestGame, IsLegal_MatchesLegalMoves_RandomPlay) {
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+        GameConfig gc = {
+            54, 1, true,
+            54, 1, true,
+            PLAYER_ABC,
+            seed
+        };
+        Game g{&gc};
+        std::mt19937 gen(seed);
+        GameCommandList moves;
+
+        while (g.get_winner() == NO_PLAYER) {
+            g.legal_moves(g.get_player_turn(), &moves);
+
+            if (moves.size == 0) { break; }
+
+            ASSERT_LT(moves.size, MOVES_LEGAL_MAX);
+
+            for (uint8_t option = NO_OPTION; option <= OPTION_CLEAR; ++option) {
+                for (uint8_t pos_hand = 0; pos_hand <= HAND_SIZE_MAX_START + 1; ++pos_hand) {
+                    for (uint8_t cvname = NO_CARAVAN; cvname <= CARAVAN_F; ++cvname) {
+                        for (uint8_t pos = 0; pos <= TRACK_NUMERIC_MAX + 1; ++pos) {
+                            GameCommand command = {
+                                static_cast<OptionType>(option), pos_hand,
+                                static_cast<CaravanName>(cvname), pos};
+
+                            ASSERT_EQ(g.is_legal(&command), lists_command(&moves, &command));
+                        }
+                    }
+                }
+            }
+
+            GameCommand chosen = moves.commands[gen() % moves.size];
+            g.play_option(&chosen);
+        }
+
+        g.close();
+    }
+}
+
+TEST (TestGame, GetVersion_ChangesOnEveryChange) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC,
+        21
+    };
+    Game g{&gc};
+    Random rng{5};
+    GameCommandList moves;
+    GameUndo undo;
+    GameState gs = g.clone();
+    uint64_t version = g.get_version();
+
+    g.legal_moves(g.get_player_turn(), &moves);
+    g.play_option(&moves.commands[0], &undo);
+    ASSERT_NE(g.get_version(), version);
+    version = g.get_version();
+
+    g.unplay(&undo);
+    ASSERT_NE(g.get_version(), version);
+    version = g.get_version();
+
+    g.determinize(PLAYER_ABC, &rng);
+    ASSERT_NE(g.get_version(), version);
+    version = g.get_version();
+
+    g.restore(&gs);
+    ASSERT_NE(g.get_version(), version);
+    version = g.get_version();
+
+    // Reading the game leaves it unchanged
+    g.get_hash();
+    g.get_winner();
+    g.legal_moves(g.get_player_turn(), &moves);
+    ASSERT_EQ(g.get_version(), version);
+
+    g.close();
+}
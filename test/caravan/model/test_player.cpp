@@ -9,7 +9,8 @@
 
 TEST (TestPlayer, GetFromHandAt_Position1) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
     Card c_get;
     Card c_take;
     Card c_getagain;
@@ -29,14 +30,16 @@ TEST (TestPlayer, GetFromHandAt_Position1) {
 
 TEST (TestPlayer, GetName) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     ASSERT_EQ(pl.get_name(), PLAYER_ABC);
 }
 
 TEST (TestPlayer, GetFromHandAt_Error_HandEmpty) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     for (int i = 0; i < 30; ++i) {
         pl.discard_from_hand_at(1);
@@ -59,7 +62,8 @@ TEST (TestPlayer, GetFromHandAt_Error_HandEmpty) {
 
 TEST (TestPlayer, GetFromHandAt_Error_PositionTooLow) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     try {
         pl.get_from_hand_at(0);
@@ -74,7 +78,8 @@ TEST (TestPlayer, GetFromHandAt_Error_PositionTooLow) {
 
 TEST (TestPlayer, GetFromHandAt_Error_PositionTooHigh) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     try {
         pl.get_from_hand_at(9);
@@ -89,21 +94,24 @@ TEST (TestPlayer, GetFromHandAt_Error_PositionTooHigh) {
 
 TEST (TestPlayer, GetSizeDeck_Deck30) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     ASSERT_EQ(pl.get_size_deck(), 22);
 }
 
 TEST (TestPlayer, GetSizeHand_Deck30) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     ASSERT_EQ(pl.get_size_hand(), 8);
 }
 
 TEST (TestPlayer, IncrementMovesCount_ThreeTimes) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     ASSERT_EQ(pl.get_moves_count(), 0);
     pl.increment_moves();
@@ -116,7 +124,8 @@ TEST (TestPlayer, IncrementMovesCount_ThreeTimes) {
 
 TEST (TestPlayer, RemoveFromHandAt_Position1_StartRound) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
     Card c_get;
     Card c_take;
     Card c_getagain;
@@ -139,7 +148,8 @@ TEST (TestPlayer, RemoveFromHandAt_Position1_StartRound) {
 
 TEST (TestPlayer, RemoveFromHandAt_Error_HandEmpty) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     for (int i = 0; i < 30; ++i) {
         pl.discard_from_hand_at(1);
@@ -160,7 +170,8 @@ TEST (TestPlayer, RemoveFromHandAt_Error_HandEmpty) {
 
 TEST (TestPlayer, RemoveFromHandAt_Error_PositionTooLow) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     try {
         pl.discard_from_hand_at(0);
@@ -175,7 +186,8 @@ TEST (TestPlayer, RemoveFromHandAt_Error_PositionTooLow) {
 
 TEST (TestPlayer, RemoveFromHandAt_Error_PositionTooHigh) {
     Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
-    Player pl = Player(PLAYER_ABC, d);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
 
     try {
         pl.discard_from_hand_at(9);
@@ -187,3 +199,40 @@ TEST (TestPlayer, RemoveFromHandAt_Error_PositionTooHigh) {
         FAIL();
     }
 }
+
+TEST (TestPlayer, SwapWithDeckTop_Position1) {
+    Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
+    uint8_t size_deck = pl.get_size_deck();
+    Card c_bottom = pl.get_from_deck_at(1);
+    Card c_top = pl.get_from_deck_at(size_deck);
+
+    pl.swap_with_deck_top(1);
+
+    ASSERT_TRUE(pl.get_from_deck_at(size_deck).suit == c_bottom.suit and
+                pl.get_from_deck_at(size_deck).rank == c_bottom.rank);
+    ASSERT_TRUE(pl.get_from_deck_at(1).suit == c_top.suit and
+                pl.get_from_deck_at(1).rank == c_top.rank);
+
+    pl.swap_with_deck_top(1);
+
+    ASSERT_TRUE(pl.get_from_deck_at(1).suit == c_bottom.suit and
+                pl.get_from_deck_at(1).rank == c_bottom.rank);
+}
+
+TEST (TestPlayer, SwapWithDeckTop_Error_PositionTooHigh) {
+    Deck *d = DeckBuilder::build_caravan_deck(30, 1, true);
+    PlayerState state{};
+    Player pl{PLAYER_ABC, &state, d};
+
+    try {
+        pl.swap_with_deck_top(pl.get_size_deck() + 1);
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
@@ -2,13 +2,15 @@
 // The following code can be redistributed and/or
 // modified under the terms of the GPL-3.0 License.
 
+#include <random>
 #include "gtest/gtest.h"
 #include "caravan/model/table.h"
 #include "caravan/core/exceptions.h"
 
 
 TEST (TestTable, ClearCaravan_TwoNumeric_OneFace) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     Card c_face = {HEARTS, KING};
@@ -25,7 +27,8 @@ TEST (TestTable, ClearCaravan_TwoNumeric_OneFace) {
 
 
 TEST (TestTable, GetCaravanBid_ThreeNumeric) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     Card c_num_3 = {SPADES, THREE};
@@ -41,7 +44,8 @@ TEST (TestTable, GetCaravanBid_ThreeNumeric) {
 }
 
 TEST (TestTable, GetCaravanCardsAt_ThreeNumeric) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {CLUBS, TWO};
     Card c_num_3 = {HEARTS, THREE};
@@ -66,7 +70,8 @@ TEST (TestTable, GetCaravanCardsAt_ThreeNumeric) {
 }
 
 TEST (TestTable, GetCaravanDirection_Ascending) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {SPADES, TWO};
     CaravanName pn = CARAVAN_A;
@@ -79,7 +84,8 @@ TEST (TestTable, GetCaravanDirection_Ascending) {
 }
 
 TEST (TestTable, GetCaravanDirection_Descending) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, TWO};
     Card c_num_2 = {SPADES, ACE};
     CaravanName pn = CARAVAN_B;
@@ -92,7 +98,8 @@ TEST (TestTable, GetCaravanDirection_Descending) {
 }
 
 TEST (TestTable, GetCaravanSize_ThreeNumeric) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {CLUBS, TWO};
     Card c_num_3 = {HEARTS, THREE};
@@ -108,7 +115,8 @@ TEST (TestTable, GetCaravanSize_ThreeNumeric) {
 }
 
 TEST (TestTable, GetCaravanSuit_BeforeAfter) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num = {SPADES, ACE};
     CaravanName pn = CARAVAN_D;
 
@@ -118,7 +126,8 @@ TEST (TestTable, GetCaravanSuit_BeforeAfter) {
 }
 
 TEST (TestTable, PlayFaceCard_Jack) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {CLUBS, TWO};
     Card c_num_3 = {HEARTS, THREE};
@@ -149,7 +158,8 @@ TEST (TestTable, PlayFaceCard_Jack) {
 }
 
 TEST (TestTable, PlayFaceCard_Queen) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {CLUBS, TWO};
     Card c_num_3 = {HEARTS, THREE};
@@ -172,7 +182,8 @@ TEST (TestTable, PlayFaceCard_Queen) {
 }
 
 TEST (TestTable, PlayFaceCard_Error_Queen_NotPlayedOnTopCard) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {CLUBS, TWO};
     Card c_num_3 = {HEARTS, THREE};
@@ -195,7 +206,8 @@ TEST (TestTable, PlayFaceCard_Error_Queen_NotPlayedOnTopCard) {
 }
 
 TEST (TestTable, PlayFaceCard_King_OneNumeric_ThreeKings) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num = {SPADES, FIVE};
     Card c_face_1 = {DIAMONDS, KING};
     Card c_face_2 = {CLUBS, KING};
@@ -216,7 +228,8 @@ TEST (TestTable, PlayFaceCard_King_OneNumeric_ThreeKings) {
 }
 
 TEST (TestTable, PlayFaceCard_Joker_Ace) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_a1 = {SPADES, ACE};
     Card c_num_a2 = {HEARTS, THREE};
     Card c_num_a3 = {SPADES, SEVEN};
@@ -247,7 +260,8 @@ TEST (TestTable, PlayFaceCard_Joker_Ace) {
 }
 
 TEST (TestTable, PlayFaceCard_Joker_2To10) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_a1 = {SPADES, TWO};
     Card c_num_a2 = {HEARTS, THREE};
     Card c_num_a3 = {HEARTS, TWO};
@@ -278,7 +292,8 @@ TEST (TestTable, PlayFaceCard_Joker_2To10) {
 }
 
 TEST (TestTable, PlayNumericCard) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, ACE};
     Card c_num_2 = {HEARTS, THREE};
     CaravanName cn = CARAVAN_D;
@@ -301,7 +316,8 @@ TEST (TestTable, PlayNumericCard) {
 }
 
 TEST (TestTable, PlayNumericCard_Error_TwoCards_SameRank_InSequence) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, THREE};
     Card c_num_2 = {DIAMONDS, THREE};
     CaravanName cn = CARAVAN_D;
@@ -320,7 +336,8 @@ TEST (TestTable, PlayNumericCard_Error_TwoCards_SameRank_InSequence) {
 }
 
 TEST (TestTable, PlayNumericCard_Error_OppositeDirection_DifferentSuit) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, FIVE};
     Card c_num_2 = {DIAMONDS, SEVEN};
     Card c_num_3 = {CLUBS, TWO};
@@ -343,7 +360,8 @@ TEST (TestTable, PlayNumericCard_Error_OppositeDirection_DifferentSuit) {
 }
 
 TEST (TestTable, PlayNumericCard_OppositeDirection_SameSuit) {
-    Table t;
+    TableState state{};
+    Table t{&state};
     Card c_num_1 = {SPADES, FIVE};
     Card c_num_2 = {DIAMONDS, SEVEN};
     Card c_num_3 = {DIAMONDS, TWO};
@@ -360,3 +378,71 @@ TEST (TestTable, PlayNumericCard_OppositeDirection_SameSuit) {
     ASSERT_EQ(t.get_caravan(cn)->get_suit(), DIAMONDS);
     ASSERT_EQ(t.get_caravan(cn)->get_direction(), DESCENDING);
 }
+
+TEST (TestTable, CaravanSummary_MatchesTrack_RandomPlay) {
+    std::mt19937 gen(42);
+    TableState state{};
+    Table t{&state};
+
+    for (int n = 0; n < 5000; ++n) {
+        CaravanName cn = static_cast<CaravanName>(CARAVAN_A + gen() % TABLE_CARAVANS_MAX);
+        Caravan *cvn = t.get_caravan(cn);
+        Card c = {static_cast<Suit>(CLUBS + gen() % 4), static_cast<Rank>(gen() % (JOKER + 1))};
+
+        if (is_numeral_card(c)) {
+            if (cvn->can_put_numeral_card(c)) {
+                t.play_numeral_card(cn, c);
+            } else if (cvn->get_size() == TRACK_NUMERIC_MAX) {
+                t.clear_caravan(cn);
+            }
+        } else if (cvn->get_size() > 0) {
+            uint8_t pos = c.rank == QUEEN ? cvn->get_size() : 1 + gen() % cvn->get_size();
+
+            if (t.can_play_face_card(cn, c, pos)) {
+                t.play_face_card(cn, c, pos);
+            }
+        }
+
+        // Recalculate each caravan's bid, direction and suit from its track
+        for (int i = CARAVAN_A; i <= CARAVAN_F; ++i) {
+            Caravan *check = t.get_caravan(static_cast<CaravanName>(i));
+            uint8_t size = check->get_size();
+            uint16_t bid = 0;
+            Direction dir = ANY;
+            Suit suit = NO_SUIT;
+
+            for (uint8_t pos = 1; pos <= size; ++pos) {
+                Slot slot = check->get_slot(pos);
+                uint16_t value = slot.card.rank + 1;
+
+                for (uint8_t f = 0; f < slot.i_faces; ++f) {
+                    if (slot.faces[f].rank == KING) { value *= 2; }
+                }
+
+                bid += value;
+            }
+
+            if (size > 0) {
+                Slot last = check->get_slot(size);
+                uint8_t num_queens = 0;
+                suit = last.card.suit;
+
+                for (uint8_t f = 0; f < last.i_faces; ++f) {
+                    if (last.faces[f].rank == QUEEN) {
+                        num_queens += 1;
+                        suit = last.faces[f].suit;
+                    }
+                }
+
+                if (size > 1) {
+                    bool ascends = last.card.rank > check->get_slot(size - 1).card.rank;
+                    dir = (ascends != (num_queens % 2 == 1)) ? ASCENDING : DESCENDING;
+                }
+            }
+
+            ASSERT_EQ(check->get_bid(), bid);
+            ASSERT_EQ(check->get_direction(), dir);
+            ASSERT_EQ(check->get_suit(), suit);
+        }
+    }
+}
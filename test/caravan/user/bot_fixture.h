@@ -0,0 +1,110 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#ifndef CARAVAN_TEST_USER_BOT_FIXTURE_H
+#define CARAVAN_TEST_USER_BOT_FIXTURE_H
+
+#include <random>
+#include "caravan/user/user.h"
+
+/**
+ * A game between two players with full, balanced decks.
+ */
+inline GameConfig bot_config(uint64_t seed, PlayerName first = PLAYER_ABC) {
+    return {
+        54, 1, true,
+        54, 1, true,
+        first,
+        seed
+    };
+}
+
+/**
+ * @return True if playing the command wins the game for the player to move.
+ *         The game is left as it was.
+ */
+inline bool wins_now(Game *game, GameCommand *command) {
+    PlayerName pturn = game->get_player_turn();
+    GameCommand copy = *command;
+    GameUndo undo;
+    bool won;
+
+    game->play_option(&copy, &undo);
+    won = game->get_winner() == pturn;
+    game->unplay(&undo);
+
+    return won;
+}
+
+/**
+ * @return True if the player to move has a choice of moves and none of them
+ *         wins at once, so a bot has to choose by its search or evaluation.
+ */
+inline bool no_win_now(Game *game) {
+    GameCommandList moves;
+
+    game->legal_moves(game->get_player_turn(), &moves);
+
+    for (uint8_t i = 0; i < moves.size; ++i) {
+        if (wins_now(game, &moves.commands[i])) { return false; }
+    }
+
+    return moves.size > 1;
+}
+
+/**
+ * Play a number of random moves, or fewer if the game ends first.
+ */
+inline void play_random(Game *game, uint64_t seed, uint16_t moves) {
+    std::mt19937 gen(seed);
+    GameCommandList legal;
+
+    for (uint16_t i = 0; i < moves and game->get_winner() == NO_PLAYER; ++i) {
+        game->legal_moves(game->get_player_turn(), &legal);
+        game->play_option(&legal.commands[gen() % legal.size]);
+    }
+}
+
+/**
+ * Play random moves until the player to move can win with some of their
+ * moves, but not with all of them, and leave the game in that position.
+ *
+ * @return True if such a position came up before the game ended.
+ */
+inline bool play_to_forced_win(Game *game, uint64_t seed) {
+    std::mt19937 gen(seed);
+    GameCommandList moves;
+
+    while (game->get_winner() == NO_PLAYER) {
+        uint8_t wins = 0;
+
+        game->legal_moves(game->get_player_turn(), &moves);
+
+        if (moves.size == 0) { return false; }
+
+        for (uint8_t i = 0; i < moves.size; ++i) {
+            wins += wins_now(game, &moves.commands[i]);
+        }
+
+        if (wins > 0 and wins < moves.size) { return true; }
+
+        game->play_option(&moves.commands[gen() % moves.size]);
+    }
+
+    return false;
+}
+
+/**
+ * Let two bots play each other for up to a number of moves.
+ */
+inline void play_bots(Game *game, UserBot *bot_abc, UserBot *bot_def, uint16_t moves) {
+    for (uint16_t i = 0; i < moves and game->get_winner() == NO_PLAYER; ++i) {
+        UserBot *bot = game->get_player_turn() == PLAYER_ABC ? bot_abc : bot_def;
+        GameCommand command = bot->request_command(game);
+
+        game->play_option(&command);
+    }
+}
+
+#endif //CARAVAN_TEST_USER_BOT_FIXTURE_H
@@ -0,0 +1,203 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <cstdio>
+#include <filesystem>
+#include "gtest/gtest.h"
+#include "caravan/user/bot/cfr.h"
+#include "bot_fixture.h"
+
+/**
+ * Exposes the strategies that the bot shares with other bots.
+ */
+class UserBotCfrProbe : public UserBotCfr {
+public:
+    using UserBotCfr::UserBotCfr;
+
+    const CfrStrategies *get_strategies() { return strategies.get(); }
+};
+
+TEST (TestCfr, InfoKey_IgnoresHiddenCards) {
+    GameConfig gc = bot_config(21);
+    Game g{&gc};
+    Random rng{5};
+    uint64_t key = cfr_info_key(&g, PLAYER_ABC);
+
+    for (int i = 0; i < 10; ++i) {
+        g.determinize(PLAYER_ABC, &rng);
+        ASSERT_EQ(cfr_info_key(&g, PLAYER_ABC), key);
+    }
+
+    g.close();
+}
+
+TEST (TestCfr, Actions_AreLegal) {
+    GameConfig gc = bot_config(22);
+    Game g{&gc};
+    Random rng{6};
+
+    for (int i = 0; i < 200 and g.get_winner() == NO_PLAYER; ++i) {
+        PlayerName pturn = g.get_player_turn();
+        GameState gs = g.clone();
+        CfrMoves moves;
+        uint16_t legal = cfr_actions(&g, pturn, &moves);
+        uint8_t a_last = 0;
+
+        if (legal == 0) { break; }
+
+        for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+            if (legal & (1 << a)) {
+                g.play_option(&moves[a]);
+                g.restore(&gs);
+                a_last = a;
+            }
+        }
+
+        g.play_option(&moves[a_last]);
+    }
+
+    g.close();
+}
+
+TEST (TestCfr, Table_FindInsert) {
+    CfrTable table{8};
+
+    ASSERT_EQ(table.find(7, false), nullptr);
+
+    CfrEntry *entry = table.find(7, true);
+
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(table.find(7, false), entry);
+    ASSERT_EQ(table.find(7, true), entry);
+    ASSERT_EQ(table.get_size(), 1);
+
+    table.close();
+}
+
+TEST (TestCfr, Update_UpdatedPlayer_AddsRegrets) {
+    CfrTable table{4};
+    CfrStep step;
+
+    step.entry = table.find(1, true);
+    step.player = PLAYER_ABC;
+    step.legal = 1 << CFR_NUMERAL_A | 1 << CFR_DISCARD;
+    step.action = CFR_DISCARD;
+    step.policy[CFR_NUMERAL_A] = 0.25;
+    step.policy[CFR_DISCARD] = 0.75;
+    step.prob_sample = 0.5;
+    step.reach_other = 0.5;
+    step.reach_sample = 0.25;
+
+    // A win is worth 1 / 0.5 = 2 for the sampled action and 0.75 * 2 = 1.5
+    // for the position, weighted by 0.5 / 0.25 = 2
+    ASSERT_DOUBLE_EQ(cfr_update(&step, PLAYER_ABC, 1), 1.5);
+    ASSERT_FLOAT_EQ(step.entry->regret[CFR_NUMERAL_A], -3);
+    ASSERT_FLOAT_EQ(step.entry->regret[CFR_DISCARD], 1);
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        ASSERT_FLOAT_EQ(step.entry->strategy[a], 0);
+
+        if (a != CFR_NUMERAL_A and a != CFR_DISCARD) {
+            ASSERT_FLOAT_EQ(step.entry->regret[a], 0);
+        }
+    }
+
+    table.close();
+}
+
+TEST (TestCfr, Update_OtherPlayer_AddsStrategy) {
+    CfrTable table{4};
+    CfrStep step;
+
+    step.entry = table.find(1, true);
+    step.player = PLAYER_DEF;
+    step.legal = 1 << CFR_NUMERAL_A | 1 << CFR_DISCARD;
+    step.action = CFR_NUMERAL_A;
+    step.policy[CFR_NUMERAL_A] = 0.25;
+    step.policy[CFR_DISCARD] = 0.75;
+    step.prob_sample = 0.25;
+    step.reach_other = 0.5;
+    step.reach_sample = 0.25;
+
+    ASSERT_DOUBLE_EQ(cfr_update(&step, PLAYER_ABC, -1), -1);
+    ASSERT_FLOAT_EQ(step.entry->strategy[CFR_NUMERAL_A], 0.5);
+    ASSERT_FLOAT_EQ(step.entry->strategy[CFR_DISCARD], 1.5);
+
+    for (uint8_t a = 0; a < CFR_ACTIONS; ++a) {
+        ASSERT_FLOAT_EQ(step.entry->regret[a], 0);
+    }
+
+    table.close();
+}
+
+TEST (TestCfr, Train_SaveLoad_PlaysOutGame) {
+    std::string path = (std::filesystem::temp_directory_path() / "test_cfr.cfr").string();
+    GameConfig gc = bot_config(0);
+    CfrTable table{14};
+    CfrTrainer trainer{&table, &gc};
+
+    trainer.train(500, 2, 1);
+    ASSERT_GT(table.get_size(), 0);
+
+    table.save(path);
+    table.close();
+
+    gc.seed = 23;
+    Game g{&gc};
+    UserBotCfr bot_abc{PLAYER_ABC, path, 1};
+    UserBotCfr bot_def{PLAYER_DEF, path, 2};
+
+    play_bots(&g, &bot_abc, &bot_def, 100);
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+
+    std::remove(path.c_str());
+}
+
+TEST (TestCfr, Load_LastBotClosed_ReadsFileAgain) {
+    std::string path = (std::filesystem::temp_directory_path() / "test_cfr_reload.cfr").string();
+    GameConfig gc = bot_config(0);
+    CfrTable table{14};
+    CfrTrainer trainer{&table, &gc};
+    size_t size_first;
+
+    trainer.train(20, 1, 1);
+    table.save(path);
+
+    UserBotCfrProbe bot_abc{PLAYER_ABC, path, 1};
+    UserBotCfrProbe bot_def{PLAYER_DEF, path, 2};
+
+    ASSERT_EQ(bot_abc.get_strategies(), bot_def.get_strategies());
+    size_first = bot_abc.get_strategies()->size();
+
+    bot_abc.close();
+    bot_def.close();
+
+    // Training on adds the strategies of information sets it had not reached
+    trainer.train(500, 1, 2);
+    table.save(path);
+    table.close();
+
+    UserBotCfrProbe bot_new{PLAYER_ABC, path, 3};
+
+    ASSERT_GT(bot_new.get_strategies()->size(), size_first);
+
+    bot_new.close();
+
+    std::remove(path.c_str());
+}
+
+TEST (TestCfr, Constructor_Error_NoFile) {
+    try {
+        UserBotCfr bot{PLAYER_ABC, "no such file.cfr"};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "gtest/gtest.h"
+#include "caravan/user/bot/expectimax.h"
+#include "caravan/user/bot/normal.h"
+#include "bot_fixture.h"
+
+
+TEST (TestExpectimax, RequestCommand_FindsWinInOne) {
+    for (uint64_t seed: {1, 8, 12}) {
+        GameConfig gc = bot_config(seed);
+        Game g{&gc};
+
+        ASSERT_TRUE(play_to_forced_win(&g, seed));
+
+        UserBotExpectimax bot{g.get_player_turn(), 3, 0, 2, 8, seed};
+        GameCommand command = bot.request_command(&g);
+
+        ASSERT_TRUE(wins_now(&g, &command));
+
+        bot.close();
+        g.close();
+    }
+}
+
+TEST (TestExpectimax, RequestCommand_PlaysOutGame) {
+    GameConfig gc = bot_config(13, PLAYER_DEF);
+    Game g{&gc};
+    UserBotExpectimax bot_abc{PLAYER_ABC, 3, 0, 2, 4, 1};
+    UserBotExpectimax bot_def{PLAYER_DEF, 3, 0, 1, 4, 2};
+
+    play_bots(&g, &bot_abc, &bot_def, 30);
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+}
+
+TEST (TestExpectimax, ExpectimaxValue_Pruned_MatchesPlain) {
+    for (uint64_t seed = 1; seed <= 4; ++seed) {
+        GameConfig gc = bot_config(seed);
+        Game g{&gc};
+        UserBotNormal bot_abc{PLAYER_ABC};
+        UserBotNormal bot_def{PLAYER_DEF};
+        Random rng{seed};
+
+        // Past the start round, so that card draws are searched
+        play_bots(&g, &bot_abc, &bot_def, 10 + seed);
+
+        ASSERT_EQ(g.get_winner(), NO_PLAYER);
+        g.determinize(PLAYER_ABC, &rng);
+
+        for (PlayerName me: {PLAYER_ABC, PLAYER_DEF}) {
+            uint64_t hash = g.get_hash();
+            double plain = expectimax_value(&g, me, 4, 3, false);
+            double pruned = expectimax_value(&g, me, 4, 3, true);
+
+            ASSERT_NEAR(pruned, plain, 1e-9);
+            ASSERT_EQ(g.get_hash(), hash);
+        }
+
+        bot_abc.close();
+        bot_def.close();
+        g.close();
+    }
+}
+
+TEST (TestExpectimax, Constructor_Error_NoDepth) {
+    try {
+        UserBotExpectimax bot{PLAYER_ABC, 0};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
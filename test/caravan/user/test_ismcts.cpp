@@ -0,0 +1,246 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <chrono>
+#include <thread>
+#include "gtest/gtest.h"
+#include "caravan/user/bot/ismcts.h"
+#include "caravan/user/bot/normal.h"
+#include "bot_fixture.h"
+
+/**
+ * Exposes the trees that the bot keeps between moves.
+ */
+class UserBotIsmctsProbe : public UserBotIsmcts {
+public:
+    using UserBotIsmcts::UserBotIsmcts;
+
+    IsmctsNode *get_tree(uint8_t i) { return trees[i]; }
+
+    void set_ponder_iterations(uint32_t iterations) { ponder_iterations = iterations; }
+
+    uint32_t get_visits() {
+        uint32_t visits = 0;
+
+        for (IsmctsNode *tree: trees) {
+            visits += tree->visits;
+        }
+
+        return visits;
+    }
+
+    void follow_reply(Game *game) { reuse_trees(game); }
+};
+
+/**
+ * @return The node's child for the move, as the search would match it, or
+ *         nullptr if it has none.
+ */
+static IsmctsNode *find_child(IsmctsNode *node, GameCommand *move) {
+    for (IsmctsNode *child: node->children) {
+        if (child->move.option == move->option and
+            child->move.hand.suit == move->hand.suit and
+            child->move.hand.rank == move->hand.rank and
+            child->move.caravan_name == move->caravan_name and
+            child->move.pos_caravan == move->pos_caravan) {
+            return child;
+        }
+    }
+
+    return nullptr;
+}
+
+
+TEST (TestIsmcts, RequestCommand_FindsWinInOne) {
+    for (uint64_t seed: {1, 8, 12}) {
+        GameConfig gc = bot_config(seed);
+        Game g{&gc};
+
+        ASSERT_TRUE(play_to_forced_win(&g, seed));
+
+        UserBotIsmcts bot{g.get_player_turn(), 1000, 0, 1, seed};
+        GameCommand command = bot.request_command(&g);
+
+        ASSERT_TRUE(wins_now(&g, &command));
+
+        bot.close();
+        g.close();
+    }
+}
+
+TEST (TestIsmcts, RequestCommand_SearchedReply_ReusesSubtree) {
+    GameConfig gc = bot_config(18);
+    Game g{&gc};
+    UserBotIsmctsProbe bot_abc{PLAYER_ABC, 200, 0, 1, 7};
+    GameCommandList replies;
+    GameCommand command;
+    IsmctsNode *mine;
+    bool found = false;
+
+    command = bot_abc.request_command(&g);
+    mine = find_child(bot_abc.get_tree(0), &command);
+    ASSERT_NE(mine, nullptr);
+    g.play_option(&command);
+
+    g.legal_moves(PLAYER_DEF, &replies);
+
+    for (uint8_t i = 0; i < replies.size and !found; ++i) {
+        command = replies.commands[i];
+        found = find_child(mine, &command) != nullptr;
+    }
+
+    ASSERT_TRUE(found);
+    g.play_option(&command);
+
+    // A fresh tree would stop at exactly 200 visits
+    command = bot_abc.request_command(&g);
+    ASSERT_GT(bot_abc.get_visits(), 200);
+
+    bot_abc.close();
+    g.close();
+}
+
+TEST (TestIsmcts, RequestCommand_PlaysOutGame) {
+    GameConfig gc = bot_config(13, PLAYER_DEF);
+    Game g{&gc};
+    UserBotIsmcts bot_abc{PLAYER_ABC, 100, 0, 2, 1};
+    UserBotIsmcts bot_def{PLAYER_DEF, 100, 0, 1, 2};
+
+    play_bots(&g, &bot_abc, &bot_def, 30);
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+}
+
+TEST (TestIsmcts, Ponder_RequestCommand_PlaysOutGame) {
+    GameConfig gc = bot_config(14);
+    Game g{&gc};
+    UserBotIsmcts bot_abc{PLAYER_ABC, 200, 0, 2, 3};
+    UserBotNormal bot_def{PLAYER_DEF};
+
+    for (int i = 0; i < 30 and g.get_winner() == NO_PLAYER; ++i) {
+        GameCommand command;
+
+        if (g.get_player_turn() == PLAYER_ABC) {
+            command = bot_abc.request_command(&g);
+            g.play_option(&command);
+            bot_abc.ponder_start(&g);
+
+        } else {
+            // The opponent moves while the bot is still pondering
+            command = bot_def.request_command(&g);
+            g.play_option(&command);
+        }
+    }
+
+    bot_abc.ponder_stop();
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+}
+
+TEST (TestIsmcts, Ponder_SearchedReply_KeepsSubtree) {
+    GameConfig gc = bot_config(16);
+    Game g{&gc};
+    UserBotIsmctsProbe bot_abc{PLAYER_ABC, 100, 0, 1, 5};
+    GameCommandList replies;
+    GameCommand command;
+    bool found = false;
+
+    command = bot_abc.request_command(&g);
+    g.play_option(&command);
+    bot_abc.ponder_start(&g);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bot_abc.ponder_stop();
+
+    g.legal_moves(PLAYER_DEF, &replies);
+
+    for (uint8_t i = 0; i < replies.size and !found; ++i) {
+        command = replies.commands[i];
+        found = find_child(bot_abc.get_tree(0), &command) != nullptr;
+    }
+
+    ASSERT_TRUE(found);
+    g.play_option(&command);
+
+    bot_abc.follow_reply(&g);
+    ASSERT_GT(bot_abc.get_visits(), 0);
+
+    bot_abc.close();
+    g.close();
+}
+
+TEST (TestIsmcts, Ponder_UnsearchedReply_DiscardsTree) {
+    GameConfig gc = bot_config(17);
+    Game g{&gc};
+    UserBotIsmctsProbe bot_abc{PLAYER_ABC, 20, 0, 1, 6};
+    GameCommandList replies;
+    GameCommand command;
+    bool found = false;
+
+    // Too few iterations to try every reply
+    bot_abc.set_ponder_iterations(1);
+
+    command = bot_abc.request_command(&g);
+    g.play_option(&command);
+    bot_abc.ponder_start(&g);
+    bot_abc.ponder_stop();
+
+    g.legal_moves(PLAYER_DEF, &replies);
+
+    for (uint8_t i = 0; i < replies.size and !found; ++i) {
+        command = replies.commands[i];
+        found = find_child(bot_abc.get_tree(0), &command) == nullptr;
+    }
+
+    ASSERT_TRUE(found);
+    g.play_option(&command);
+
+    bot_abc.follow_reply(&g);
+    ASSERT_EQ(bot_abc.get_visits(), 0);
+    ASSERT_TRUE(bot_abc.get_tree(0)->children.empty());
+
+    bot_abc.close();
+    g.close();
+}
+
+TEST (TestIsmcts, Destructor_WhilePondering_StopsThreads) {
+    GameConfig gc = bot_config(15);
+    Game g{&gc};
+
+    {
+        UserBotIsmcts bot{PLAYER_ABC, 50, 0, 2, 4};
+        GameCommand command = bot.request_command(&g);
+
+        g.play_option(&command);
+        bot.ponder_start(&g);
+    }
+
+    g.close();
+}
+
+TEST (TestIsmcts, Constructor_Error_NoBudget) {
+    try {
+        UserBotIsmcts bot{PLAYER_ABC, 0, 0};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
+
+TEST (TestIsmcts, Constructor_Error_TooManyThreads) {
+    try {
+        UserBotIsmcts bot{PLAYER_ABC, 10, 0, ISMCTS_THREADS_MAX + 1};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
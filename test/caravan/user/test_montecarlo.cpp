@@ -0,0 +1,136 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <chrono>
+#include "gtest/gtest.h"
+#include "caravan/user/bot/montecarlo.h"
+#include "caravan/user/bot/playout.h"
+#include "bot_fixture.h"
+
+/**
+ * Exposes how many playouts the bot ran for its last move.
+ */
+class UserBotMonteCarloProbe : public UserBotMonteCarlo {
+public:
+    using UserBotMonteCarlo::UserBotMonteCarlo;
+
+    uint32_t get_playouts() { return last_playouts; }
+};
+
+
+TEST (TestMonteCarlo, RequestCommand_FindsWinInOne) {
+    for (uint64_t seed: {1, 8, 12}) {
+        GameConfig gc = bot_config(seed);
+        Game g{&gc};
+
+        ASSERT_TRUE(play_to_forced_win(&g, seed));
+
+        UserBotMonteCarlo bot{g.get_player_turn(), 1000, 0, 1, true, seed};
+        GameCommand command = bot.request_command(&g);
+
+        ASSERT_TRUE(wins_now(&g, &command));
+
+        bot.close();
+        g.close();
+    }
+}
+
+TEST (TestMonteCarlo, RequestCommand_PrefersBetterPlayouts) {
+    // After these moves, ABC playing its QUEEN on caravan C wins about 77%
+    // of 1,000 playouts of it, and no other move more than 61%
+    for (uint64_t seed: {1, 2, 3}) {
+        GameConfig gc = bot_config(15);
+        Game g{&gc};
+
+        play_random(&g, 15, 30);
+        ASSERT_EQ(g.get_player_turn(), PLAYER_ABC);
+        ASSERT_TRUE(no_win_now(&g));
+
+        UserBotMonteCarlo bot{PLAYER_ABC, 2000, 0, 1, true, seed};
+        GameCommand command = bot.request_command(&g);
+
+        ASSERT_EQ(command.option, OPTION_PLAY);
+        ASSERT_EQ(g.get_player(PLAYER_ABC)->get_from_hand_at(command.pos_hand).rank, QUEEN);
+        ASSERT_EQ(command.caravan_name, CARAVAN_C);
+
+        bot.close();
+        g.close();
+    }
+}
+
+TEST (TestMonteCarlo, RequestCommand_PlayoutBudget_RunsExactly) {
+    GameConfig gc = bot_config(15);
+    Game g{&gc};
+
+    play_random(&g, 15, 30);
+    ASSERT_TRUE(no_win_now(&g));
+
+    for (uint32_t threads: {1, 3}) {
+        UserBotMonteCarloProbe bot{g.get_player_turn(), 100, 0, threads, true, 1};
+
+        bot.request_command(&g);
+        ASSERT_EQ(bot.get_playouts(), 100);
+
+        bot.close();
+    }
+
+    g.close();
+}
+
+TEST (TestMonteCarlo, RequestCommand_TimeBudget_StopsInTime) {
+    GameConfig gc = bot_config(15);
+    Game g{&gc};
+    UserBotMonteCarloProbe bot{PLAYER_ABC, 0, 50, 1, true, 1};
+
+    play_random(&g, 15, 30);
+    ASSERT_TRUE(no_win_now(&g));
+
+    auto start = std::chrono::steady_clock::now();
+    bot.request_command(&g);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_GT(bot.get_playouts(), 0);
+    ASSERT_LT(elapsed, std::chrono::milliseconds(500));
+
+    bot.close();
+    g.close();
+}
+
+TEST (TestMonteCarlo, RequestCommand_PlaysOutGame) {
+    GameConfig gc = bot_config(11);
+    Game g{&gc};
+    UserBotMonteCarlo bot_abc{PLAYER_ABC, 50, 0, 2, false, 1};
+    UserBotMonteCarlo bot_def{PLAYER_DEF, 50, 0, 2, true, 2};
+
+    play_bots(&g, &bot_abc, &bot_def, PLAYOUT_MOVES_MAX);
+    ASSERT_NE(g.get_winner(), NO_PLAYER);
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+}
+
+TEST (TestMonteCarlo, Constructor_Error_NoBudget) {
+    try {
+        UserBotMonteCarlo bot{PLAYER_ABC, 0, 0};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
+
+TEST (TestMonteCarlo, Constructor_Error_TooManyThreads) {
+    try {
+        UserBotMonteCarlo bot{PLAYER_ABC, 10, 0, MONTECARLO_THREADS_MAX + 1};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
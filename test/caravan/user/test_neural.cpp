@@ -0,0 +1,224 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include "gtest/gtest.h"
+#include "caravan/user/bot/neural.h"
+#include "bot_fixture.h"
+
+/**
+ * Sets a network's weights by hand.
+ */
+class NeuralNetProbe : public NeuralNet {
+public:
+    using NeuralNet::NeuralNet;
+
+    /**
+     * Turn a network with one hidden unit into one whose value rises with
+     * the total bid of the player's own caravans, which come first in the
+     * features.
+     */
+    void set_bids_net() {
+        for (NeuralLayer &layer: layers) {
+            std::fill(layer.weights.begin(), layer.weights.end(), 0.0f);
+            std::fill(layer.biases.begin(), layer.biases.end(), 0.0f);
+        }
+
+        for (uint16_t i = 0; i < 3; ++i) {
+            uint16_t bid = i * FEATURES_CARAVAN + FEATURES_SLOT * TRACK_NUMERIC_MAX;
+            layers[0].weights[bid * layers[0].stride] = 1;
+        }
+
+        layers[1].weights[0] = 1;
+    }
+};
+
+/**
+ * Exposes the network that the bot shares with other bots.
+ */
+class UserBotNeuralProbe : public UserBotNeural {
+public:
+    using UserBotNeural::UserBotNeural;
+
+    const NeuralNet *get_net() { return net.get(); }
+};
+
+/**
+ * @return The total bid of the caravans of the player to move, after they
+ *         play the command. The game is left as it was.
+ */
+static uint16_t bids_after(Game *g, GameCommand *command) {
+    PlayerCaravanNames pcns = g->get_player_caravan_names(g->get_player_turn());
+    GameCommand copy = *command;
+    GameUndo undo;
+    uint16_t bids = 0;
+
+    g->play_option(&copy, &undo);
+
+    for (CaravanName cvname: pcns) {
+        bids += g->get_table()->get_caravan(cvname)->get_bid();
+    }
+
+    g->unplay(&undo);
+
+    return bids;
+}
+
+
+TEST (TestNeural, Features_IgnoreHiddenCards) {
+    GameConfig gc = bot_config(31);
+    Game g{&gc};
+    Random rng{7};
+    Features expected;
+    Features features;
+
+    encode_features(&g, PLAYER_ABC, &expected);
+
+    for (int i = 0; i < 10; ++i) {
+        g.determinize(PLAYER_ABC, &rng);
+        encode_features(&g, PLAYER_ABC, &features);
+        ASSERT_EQ(features, expected);
+    }
+
+    g.close();
+}
+
+TEST (TestNeural, Evaluate_KernelsAgree) {
+    GameConfig gc = bot_config(32);
+    Game g{&gc};
+    NeuralNet net{{64, 32}, 3};
+    Features features;
+
+    encode_features(&g, PLAYER_ABC, &features);
+    net.set_kernel(NEURAL_SCALAR);
+    float expected = net.evaluate(&features);
+
+    for (NeuralKernel k: {NEURAL_SSE, NEURAL_AVX2}) {
+        if (NeuralNet::supports(k)) {
+            net.set_kernel(k);
+            ASSERT_NEAR(net.evaluate(&features), expected, 1e-4);
+        }
+    }
+
+    net.close();
+    g.close();
+}
+
+TEST (TestNeural, SaveLoad_PlaysOutGame) {
+    std::string path = (std::filesystem::temp_directory_path() / "test_neural.nn").string();
+    GameConfig gc = bot_config(33);
+    Game g{&gc};
+    NeuralNet net{{32, 32}, 4};
+    Features features;
+
+    net.save(path);
+
+    NeuralNet loaded{path};
+    encode_features(&g, PLAYER_ABC, &features);
+    ASSERT_FLOAT_EQ(loaded.evaluate(&features), net.evaluate(&features));
+
+    net.close();
+    loaded.close();
+
+    UserBotNeural bot_abc{PLAYER_ABC, path};
+    UserBotNeural bot_def{PLAYER_DEF, path};
+
+    play_bots(&g, &bot_abc, &bot_def, 100);
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+
+    std::remove(path.c_str());
+}
+
+TEST (TestNeural, RequestCommand_PicksHighestValue) {
+    std::string path = (std::filesystem::temp_directory_path() / "test_neural_bids.nn").string();
+    NeuralNetProbe net{{1}, 5};
+
+    net.set_bids_net();
+    net.save(path);
+    net.close();
+
+    for (uint64_t seed: {1, 2, 3, 4}) {
+        GameConfig gc = bot_config(seed);
+        Game g{&gc};
+
+        play_random(&g, seed, 20);
+        ASSERT_TRUE(no_win_now(&g));
+
+        PlayerName pturn = g.get_player_turn();
+        UserBotNeural bot{pturn, path};
+        GameCommandList moves;
+        GameCommand command = bot.request_command(&g);
+        uint16_t bids_min = UINT16_MAX;
+        uint16_t bids_max = 0;
+
+        g.legal_moves(pturn, &moves);
+
+        for (uint8_t i = 0; i < moves.size; ++i) {
+            uint16_t bids = bids_after(&g, &moves.commands[i]);
+
+            bids_min = std::min(bids_min, bids);
+            bids_max = std::max(bids_max, bids);
+        }
+
+        ASSERT_LT(bids_min, bids_max);
+        ASSERT_EQ(bids_after(&g, &command), bids_max);
+
+        bot.close();
+        g.close();
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST (TestNeural, Load_LastBotClosed_ReadsFileAgain) {
+    std::string path = (std::filesystem::temp_directory_path() / "test_neural_reload.nn").string();
+    GameConfig gc = bot_config(34);
+    Game g{&gc};
+    NeuralNet net_first{{16}, 6};
+    NeuralNet net_second{{16}, 7};
+    Features features;
+
+    encode_features(&g, PLAYER_ABC, &features);
+    ASSERT_NE(net_first.evaluate(&features), net_second.evaluate(&features));
+
+    net_first.save(path);
+
+    UserBotNeuralProbe bot_abc{PLAYER_ABC, path};
+    UserBotNeuralProbe bot_def{PLAYER_DEF, path};
+
+    ASSERT_EQ(bot_abc.get_net(), bot_def.get_net());
+    ASSERT_FLOAT_EQ(bot_abc.get_net()->evaluate(&features), net_first.evaluate(&features));
+
+    bot_abc.close();
+    bot_def.close();
+    net_second.save(path);
+
+    UserBotNeuralProbe bot_new{PLAYER_ABC, path};
+
+    ASSERT_FLOAT_EQ(bot_new.get_net()->evaluate(&features), net_second.evaluate(&features));
+
+    bot_new.close();
+    net_first.close();
+    net_second.close();
+    g.close();
+
+    std::remove(path.c_str());
+}
+
+TEST (TestNeural, Constructor_Error_NoFile) {
+    try {
+        UserBotNeural bot{PLAYER_ABC, "no such file.nn"};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}
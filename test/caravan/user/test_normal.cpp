@@ -0,0 +1,63 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include "gtest/gtest.h"
+#include "caravan/user/bot/normal.h"
+#include "caravan/user/bot/friendly.h"
+
+
+TEST (TestNormal, RequestMove_FormatsRequestCommand) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC,
+        41
+    };
+    Game g{&gc};
+    UserBotNormal bot_abc{PLAYER_ABC};
+    UserBotFriendly bot_def{PLAYER_DEF};
+
+    for (int i = 0; i < 200 and g.get_winner() == NO_PLAYER; ++i) {
+        UserBot *bot = g.get_player_turn() == PLAYER_ABC ?
+            (UserBot *) &bot_abc : (UserBot *) &bot_def;
+        GameCommand command = bot->request_command(&g);
+        GameCommand parsed;
+
+        parse_command(bot->request_move(&g), &parsed);
+        ASSERT_EQ(parsed.option, command.option);
+        ASSERT_EQ(parsed.pos_hand, command.pos_hand);
+        ASSERT_EQ(parsed.caravan_name, command.caravan_name);
+        ASSERT_EQ(parsed.pos_caravan, command.pos_caravan);
+
+        g.play_option(&command);
+    }
+
+    bot_abc.close();
+    bot_def.close();
+    g.close();
+}
+
+TEST (TestNormal, RequestCommand_Error_Closed) {
+    GameConfig gc = {
+        54, 1, true,
+        54, 1, true,
+        PLAYER_ABC
+    };
+    Game g{&gc};
+    UserBotNormal bot{PLAYER_ABC};
+
+    bot.close();
+
+    try {
+        bot.request_command(&g);
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+
+    g.close();
+}
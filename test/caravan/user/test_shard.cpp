@@ -0,0 +1,88 @@
+// Copyright (c) 2022-2024 r3w0p
+// The following code can be redistributed and/or
+// modified under the terms of the GPL-3.0 License.
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include "gtest/gtest.h"
+#include "caravan/user/bot/shard.h"
+
+
+TEST (TestShard, Write_SplitsIntoShards) {
+    std::string prefix = (std::filesystem::temp_directory_path() / "test_shard").string();
+    ShardWriter writer{prefix, 3};
+    std::vector<ShardRecord> records(5);
+
+    for (uint16_t i = 0; i < records.size(); ++i) {
+        records[i].features[i] = 1;
+        records[i].player = PLAYER_ABC;
+        records[i].winner = PLAYER_DEF;
+        records[i].move = i;
+    }
+
+    writer.write(records.data(), 2);
+    writer.write(records.data() + 2, 3);
+    ASSERT_EQ(writer.get_records(), 5);
+    ASSERT_EQ(writer.get_shards(), 2);
+    writer.close();
+
+    for (uint32_t s = 0; s < 2; ++s) {
+        std::string path = ShardWriter::shard_path(prefix, s);
+        std::ifstream in(path, std::ios::binary);
+        ShardHeader header;
+
+        in.read((char *) &header, sizeof(header));
+        ASSERT_EQ(header.magic, SHARD_MAGIC);
+        ASSERT_EQ(header.version, SHARD_VERSION);
+        ASSERT_EQ(header.byte_order, SHARD_BYTE_ORDER);
+        ASSERT_EQ(header.size_header, sizeof(ShardHeader));
+        ASSERT_EQ(header.size_record, sizeof(ShardRecord));
+        ASSERT_EQ(header.size_features, FEATURES_SIZE);
+        ASSERT_EQ(header.records, s == 0 ? 3 : 2);
+        ASSERT_EQ(std::filesystem::file_size(path),
+                  header.size_header + header.records * header.size_record);
+
+        for (uint64_t r = 0; r < header.records; ++r) {
+            ShardRecord record;
+            uint16_t move = s * 3 + r;
+
+            in.read((char *) &record, sizeof(record));
+            ASSERT_EQ(record.move, move);
+            ASSERT_EQ(record.features[move], 1);
+            ASSERT_EQ(record.player, PLAYER_ABC);
+            ASSERT_EQ(record.winner, PLAYER_DEF);
+        }
+
+        in.close();
+        std::remove(path.c_str());
+    }
+}
+
+TEST (TestShard, EncodeCommand_CopiesEveryField) {
+    GameCommand command{
+        OPTION_PLAY, 3, CARAVAN_E, 2, {HEARTS, KING}, {SPADES, SEVEN}};
+    ShardRecord record;
+
+    encode_command(&command, &record);
+    ASSERT_EQ(record.option, OPTION_PLAY);
+    ASSERT_EQ(record.pos_hand, 3);
+    ASSERT_EQ(record.caravan_name, CARAVAN_E);
+    ASSERT_EQ(record.pos_caravan, 2);
+    ASSERT_EQ(record.hand_rank, KING);
+    ASSERT_EQ(record.hand_suit, HEARTS);
+    ASSERT_EQ(record.board_rank, SEVEN);
+    ASSERT_EQ(record.board_suit, SPADES);
+}
+
+TEST (TestShard, Constructor_Error_NoRecords) {
+    try {
+        ShardWriter writer{"test_shard", 0};
+        FAIL();
+
+    } catch (CaravanFatalException &e) {
+
+    } catch (...) {
+        FAIL();
+    }
+}